@@ -14,7 +14,7 @@ constexpr static auto insns = arch::Insns
     }},
     std::pair{"prntln", [](const auto& src)
     {
-        std::println("{}", src);
+        io::println("{}", src);
     }},
 };
 
@@ -56,6 +56,34 @@ namespace mint
         template<class... Strs> Keywords(std::pair<Strs, Traits>...)
             -> Keywords<sizeof...(Strs)>;
 
+        // Optimizations an instruction permits; declared per opcode by the architecture.
+        export enum class Legal: std::uint8_t
+        {
+            None = 0b000,
+
+            // Fully writes its first operand from its remaining operands alone, without any other effect.
+            Pure = 0b001,
+
+            // Copies its second operand into its first; implies `Pure`.
+            Move = 0b011,
+
+            // May be fused with an adjacent instruction into a `first.second` superinstruction.
+            Fuse = 0b100,
+        };
+
+        export constexpr auto operator|(const Legal first, const Legal second) noexcept
+            -> Legal
+        {
+            return static_cast<Legal>(std::to_underlying(first) | std::to_underlying(second));
+        };
+
+        // Returns if `legal` permits every optimization within `required`.
+        export constexpr auto allows(const Legal legal, const Legal required) noexcept
+            -> bool
+        {
+            return (std::to_underlying(legal) & std::to_underlying(required)) == std::to_underlying(required);
+        };
+
         // User-defined instruction function alternatives.
         template<class... Ts> using Insn = xxas::meta::DedupExtend_t<std::variant<Ts...[0]>, Ts...>;
 
@@ -80,8 +108,41 @@ namespace mint
         // Register ids -> initialization.
         arch::Keywords<N> keywords;
 
-        constexpr Arch(arch::Insns<Insns...> insns, arch::Keywords<N> keywords)
-          : insns(insns), keywords(keywords) {};
+        // Opcode -> permitted optimizations; opcodes not declared permit none.
+        std::array<arch::Legal, sizeof...(Insns)> legality{};
+
+        template<class... Strs> constexpr Arch(arch::Insns<Insns...> insns, arch::Keywords<N> keywords, std::pair<Strs, arch::Legal>... legal)
+          : insns(insns), keywords(keywords)
+        {   // An undeclared mnemonic indexes past the opcodes, failing constant evaluation.
+            ((this->legality[std::distance(this->insns.cbegin(), this->insns.find(std::string_view(legal.first)))] = legal.second), ...);
+        };
+
+        // Returns the optimizations the opcode permits.
+        constexpr auto legal(const std::size_t opcode) const noexcept
+            -> arch::Legal
+        {
+            return opcode < this->legality.size() ? this->legality[opcode] : arch::Legal::None;
+        };
+
+        // Returns the opcode of the superinstruction fusing `first` followed by `second`, named `first.second`.
+        constexpr auto fused(const std::size_t first, const std::size_t second) const
+            -> std::optional<std::size_t>
+        {
+            if(!arch::allows(this->legal(first), arch::Legal::Fuse) || !arch::allows(this->legal(second), arch::Legal::Fuse))
+            {
+                return std::nullopt;
+            };
+
+            auto name = std::string(this->insns.entries[first].first) + '.' + std::string(this->insns.entries[second].first);
+            auto it   = this->insns.find(std::string_view(name));
+
+            if(it == this->insns.cend())
+            {
+                return std::nullopt;
+            };
+
+            return static_cast<std::size_t>(std::distance(this->insns.cbegin(), it));
+        };
 
         // Initializes a new register file.
         constexpr auto get_registers() const
@@ -91,6 +152,6 @@ namespace mint
         };
     };
 
-    template<class... Insns, std::size_t N> Arch(arch::Insns<Insns...>, arch::Keywords<N>)
+    template<class... Insns, std::size_t N, class... Strs> Arch(arch::Insns<Insns...>, arch::Keywords<N>, std::pair<Strs, arch::Legal>...)
       -> Arch<arch::Insns<Insns...>, arch::Keywords<N>>;
 };
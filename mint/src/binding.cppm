@@ -15,6 +15,36 @@ import :context;
 
 namespace mint
 {
+    namespace binding
+    {   // Argument of type `T` bound to a byte slice by reference.
+        export template<class T> struct Bound
+        {
+            using Type = T&;
+
+            constexpr static inline std::size_t alignment = alignof(std::remove_reference_t<T>);
+
+            static auto from(std::byte* data)
+                -> Type
+            {
+                return *reinterpret_cast<std::remove_reference_t<T>*>(data);
+            };
+        };
+
+        // Atomic argument bound to a byte slice; accesses bypass the page mutex.
+        export template<class T> struct Bound<std::atomic_ref<T>>
+        {
+            using Type = std::atomic_ref<T>;
+
+            constexpr static inline std::size_t alignment = std::atomic_ref<T>::required_alignment;
+
+            static auto from(std::byte* data)
+                -> Type
+            {
+                return std::atomic_ref<T>(*reinterpret_cast<T*>(data));
+            };
+        };
+    };
+
     export struct Binding
     {
         enum class CreateErr: std::uint8_t
@@ -53,16 +83,13 @@ namespace mint
         {   // Not enough byte spans provided to extract arguments from.
             if(spans.size() < sizeof...(Args))
             {
-                std::size_t types_size   = (0uz + ... + sizeof(Args));
-                auto typename_str        = xxas::format::demangled_typename<std::tuple<Args...>>();
-
-                return xxas::error(CreateErr::BytesLen, std::format("Not enough data ({} bytes) provided for {} ({}bytes)", spans.size(), typename_str, types_size));
+                return xxas::error(CreateErr::BytesLen, "Not enough byte spans provided for {} arguments", sizeof...(Args));
             };
 
             auto is_aligned = [&]<auto... In>(std::index_sequence<In...>)
                 -> bool
             {
-                return ((reinterpret_cast<std::uintptr_t>(spans.at(In).data()) % alignof(Args) == 0) && ...);
+                return ((reinterpret_cast<std::uintptr_t>(spans.at(In).data()) % binding::Bound<Args>::alignment == 0) && ...);
             };
 
             if(!is_aligned(std::index_sequence_for<Args...>{}))
@@ -71,11 +98,11 @@ namespace mint
             };
 
             auto get_tuple_refs = [&]<auto... In>(std::index_sequence<In...>)
-                -> std::tuple<Args&...>
+                -> std::tuple<typename binding::Bound<Args>::Type...>
             {
                 return
                 {
-                    *reinterpret_cast<std::remove_reference_t<Args>*>(spans[In].data())...
+                    binding::Bound<Args>::from(spans[In].data())...
                 };
             };
 
@@ -86,10 +113,10 @@ namespace mint
             {    // Capture the original function as a reference and the arguments moved into the function.
                 .function = [funct = std::cref(funct), args = std::move(arg_refs)]
                     -> Result
-                {   // Unpack the arguments and perfectly forward them to the function.
-                    return std::apply([&funct](auto&&... unpacked_args)
+                {   // Unpack the bound arguments and pass them to the function.
+                    return std::apply([&funct](auto&... unpacked_args)
                     {
-                        return std::invoke(funct, std::forward<Args>(unpacked_args)...);
+                        return std::invoke(funct, unpacked_args...);
                     }, args);
                 },
             };
@@ -0,0 +1,335 @@
+export module mint: comptime;
+
+import std;
+import xxas;
+
+import :memory;
+import :traits;
+import :scalar;
+import :wide;
+import :expression;
+import :operand;
+import :instruction;
+import :dispatch;
+
+/*** **
+ **
+ **  module:   mint: comptime
+ **  purpose:  Constant evaluated execution of guest programs over a constexpr register
+ **            file and memory image, yielding the image as a constexpr data segment.
+ **
+ *** **/
+
+namespace mint
+{
+    namespace comptime
+    {   // Bytes of the default memory image.
+        export constexpr inline std::size_t default_image_size = 0x1000;
+
+        // Widest operand value; registers and operands are held at this width.
+        export using Value = Wide<512uz>;
+        export using Bytes = std::array<std::byte, sizeof(Value)>;
+
+        // Constexpr counterpart of `mint::Operand`, holding its value in place of an expression.
+        export struct Operand
+        {
+            Traits traits{};
+
+            // Keyword index of a register, value of an immediate, or virtual address of memory.
+            Value  value{};
+        };
+
+        export struct Instruction
+        {
+            std::size_t                                        opcode{};
+            std::array<comptime::Operand, dispatch::max_arity> operands{};
+            std::size_t                                        count{};
+        };
+
+        export template<std::size_t N> using Code = std::array<comptime::Instruction, N>;
+
+        // Memory image of `Size` bytes placed at `base`.
+        export template<std::size_t Size> struct Segment
+        {
+            std::uintptr_t              base{mem::default_base_addr};
+            std::array<std::byte, Size> bytes{};
+
+            // Returns the word of type `W` at `vaddr`.
+            template<class W> constexpr auto read(const std::uintptr_t vaddr) const
+                -> W
+            {
+                std::array<std::byte, sizeof(W)> word{};
+                std::ranges::copy_n(this->bytes.begin() + (vaddr - this->base), sizeof(W), word.begin());
+
+                return std::bit_cast<W>(word);
+            };
+        };
+    };
+
+    // Interprets guest programs during constant evaluation, or at runtime, through the same
+    // instruction functions as `Dispatch`; registers and memory are held by value instead of
+    // by a thread and process context.
+    export template<const auto& arch, std::size_t Size = comptime::default_image_size> struct Comptime
+    {
+        using Dispatch  = mint::Dispatch<arch>;
+        using Result    = typename Dispatch::Result;
+        using Err       = typename Dispatch::Err;
+        using Registers = std::array<comptime::Bytes, std::tuple_size_v<decltype(arch.keywords.entries)>>;
+
+        // Indexed by keyword, as register operands are.
+        Registers               registers{};
+        comptime::Segment<Size> image{};
+        std::size_t             ip{};
+
+        constexpr explicit Comptime(const std::uintptr_t base = mem::default_base_addr) noexcept
+            : image{.base = base} {};
+
+        // Returns a register operand for the keyword named `name`, with its declared traits.
+        constexpr static auto reg(const std::string_view name)
+            -> comptime::Operand
+        {   // `at` throws on an undeclared keyword, failing constant evaluation.
+            auto index = static_cast<std::size_t>(std::distance(arch.keywords.cbegin(), arch.keywords.find(name)));
+            return comptime::Operand{arch.keywords.entries.at(index).second, index};
+        };
+
+        // Returns the instruction of mnemonic `mnemonic` over `operands`.
+        template<std::same_as<comptime::Operand>... Ops> requires(sizeof...(Ops) <= dispatch::max_arity)
+        constexpr static auto insn(const std::string_view mnemonic, const Ops&... operands)
+            -> comptime::Instruction
+        {   // `at` throws on an undeclared mnemonic, failing constant evaluation.
+            auto opcode = static_cast<std::size_t>(std::distance(arch.insns.cbegin(), arch.insns.find(mnemonic)));
+            static_cast<void>(arch.insns.entries.at(opcode));
+
+            return comptime::Instruction{.opcode = opcode, .operands = {operands...}, .count = sizeof...(Ops)};
+        };
+
+        // Runs `code` to completion during constant evaluation, yielding the memory image.
+        template<std::size_t N> consteval static auto segment(const comptime::Code<N>& code, const std::uintptr_t base = mem::default_base_addr)
+            -> comptime::Segment<Size>
+        {
+            Comptime machine{base};
+
+            // `value` throws on a failing instruction, failing constant evaluation.
+            machine.run(code).value();
+            return machine.image;
+        };
+
+        // Creates the runtime IR of `code`, for execution through `Dispatch`.
+        static auto program(const std::span<const comptime::Instruction> code)
+            -> Program
+        {
+            Program program{};
+
+            for(const auto& insn: code)
+            {
+                auto operands = program.operands();
+
+                for(const auto& operand: std::span(insn.operands).first(insn.count))
+                {   // The leaf holds the whole value; handlers read only as many bytes as their word.
+                    auto* value = std::construct_at(static_cast<comptime::Value*>(program.arena()->allocate(sizeof(comptime::Value), alignof(comptime::Value))), operand.value);
+                    operands.push_back(Operand{Expression{Scalar::from(*value), program.arena()}, operand.traits});
+                };
+
+                program.push(insn.opcode, std::move(operands));
+            };
+
+            return program;
+        };
+
+        // Returns the register named `name` as a word of type `W`.
+        template<class W> constexpr auto read(const std::string_view name) const
+            -> W
+        {   // `at` throws on an undeclared keyword.
+            auto index = static_cast<std::size_t>(std::distance(arch.keywords.cbegin(), arch.keywords.find(name)));
+
+            std::array<std::byte, sizeof(W)> word{};
+            std::ranges::copy_n(this->registers.at(index).begin(), sizeof(W), word.begin());
+
+            return std::bit_cast<W>(word);
+        };
+
+        // Runs from the ip to the end of `code`, stopping at the first failing instruction.
+        constexpr auto run(const std::span<const comptime::Instruction> code)
+            -> Result
+        {
+            for(; this->ip < code.size(); ++this->ip)
+            {
+                if(auto result = this->execute(code[this->ip]); !result)
+                {
+                    return result;
+                };
+            };
+
+            return {};
+        };
+
+        // Executes an instruction, selecting its word as `Dispatch::find` selects a handler.
+        constexpr auto execute(const comptime::Instruction& insn)
+            -> Result
+        {
+            if(insn.opcode >= arch.insns.entries.size())
+            {
+                return xxas::error(Err::Opcode, "Cannot find a matching function for opcode: {}", insn.opcode);
+            };
+
+            std::uint8_t bitness = 0u;
+            for(const auto& operand: std::span(insn.operands).first(insn.count))
+            {
+                if(traits::index(operand.traits.get_as<traits::Source>()) >= dispatch::sources.size())
+                {
+                    return xxas::error(Err::Unsupported, "Opcode {} has an operand without a single source", insn.opcode);
+                };
+
+                bitness = std::max<std::uint8_t>(bitness, operand.traits.get<traits::Bitness>());
+            };
+
+            auto width = traits::index(static_cast<traits::Bitness>(bitness));
+
+            if(bitness == 0u || width >= dispatch::widths<arch>)
+            {
+                return xxas::error(Err::Unsupported, "Opcode {} has no specialized handler for its operands", insn.opcode);
+            };
+
+            Result result{};
+            [&]<auto... Width>(std::index_sequence<Width...>)
+            {
+                static_cast<void>(((Width == width && (result = this->template invoke<dispatch::bitnesses[Width]>(insn), true)) || ...));
+            }(std::make_index_sequence<dispatch::widths<arch>>{});
+
+            return result;
+        };
+
+        // Returns the bytes an operand is read from and written to; immediates have none.
+        // Memory operands span their own width, as `Dispatch` copies them.
+        template<class W> constexpr auto locate(const comptime::Operand& operand)
+            -> xxas::Result<std::span<std::byte>, Operand::Err, Memory::Err>
+        {
+            auto source = operand.traits.get_as<traits::Source>();
+
+            if(source == traits::Source::Register)
+            {
+                auto regid = static_cast<std::size_t>(operand.value);
+
+                if(regid >= this->registers.size())
+                {
+                    return xxas::error(Operand::Err::Uninitialized, "Register id {} is not a keyword", regid);
+                };
+
+                // Keywords that aren't registers have no storage.
+                const auto& keyword = arch.keywords.entries[regid].second;
+                auto        size    = keyword.template get_as<traits::Source>() == traits::Source::Register ? keyword.size() : 0uz;
+
+                if(size < sizeof(W))
+                {
+                    return xxas::error(Operand::Err::Casting, "Register of {} bytes is narrower than the handler word", size);
+                };
+
+                return std::span<std::byte>(this->registers[regid]);
+            }
+            else if(source == traits::Source::Memory)
+            {
+                auto vaddr = static_cast<std::uintptr_t>(operand.value);
+                auto size  = dispatch::width<W>(operand.traits);
+
+                if(vaddr < this->image.base || vaddr - this->image.base + size > Size)
+                {
+                    return xxas::error(Memory::Err::OutOfRange, "vaddr of {:#x} is out of range", vaddr);
+                };
+
+                return std::span<std::byte>(this->image.bytes).subspan(vaddr - this->image.base, size);
+            };
+
+            return std::span<std::byte>{};
+        };
+
+        // Invokes the instruction function with words of bitness `B`.
+        template<traits::Bitness B> constexpr auto invoke(const comptime::Instruction& insn)
+            -> Result
+        {
+            using Word = dispatch::Word<B>;
+
+            return std::visit([&]<class F>(const F& funct)
+                -> Result
+            {
+                constexpr auto arity = dispatch::arity<F, Word>();
+
+                if constexpr(arity == dispatch::npos)
+                {
+                    return xxas::error(Err::Unsupported, "Opcode {} has no specialized handler for its operands", insn.opcode);
+                }
+                else
+                {
+                    if(insn.count != arity)
+                    {
+                        return xxas::error(Err::Unsupported, "Opcode {} has no specialized handler for its operands", insn.opcode);
+                    };
+
+                    std::array<std::span<std::byte>, arity> spans{};
+                    std::array<Word, arity>                 words{};
+
+                    // Operands of the same register or address share a word, as handlers share their storage.
+                    std::array<std::size_t, arity> shared{};
+
+                    for(auto n = 0uz; n < arity; ++n)
+                    {
+                        auto located = this->template locate<Word>(insn.operands[n]);
+                        if(!located)
+                        {
+                            return std::move(located.error());
+                        };
+
+                        spans[n]  = *located;
+                        shared[n] = n;
+
+                        if(spans[n].empty())
+                        {   // Immediates are truncated to the word, as handlers widen them.
+                            words[n] = static_cast<Word>(insn.operands[n].value);
+                            continue;
+                        };
+
+                        // Narrower memory operands are zero extended.
+                        std::array<std::byte, sizeof(Word)> bytes{};
+                        std::ranges::copy_n(spans[n].begin(), std::min(spans[n].size(), sizeof(Word)), bytes.begin());
+                        words[n] = std::bit_cast<Word>(bytes);
+
+                        for(auto m = 0uz; m < n; ++m)
+                        {
+                            if(spans[m].data() == spans[n].data() && spans[m].size() == spans[n].size())
+                            {
+                                shared[n] = m;
+                                break;
+                            };
+                        };
+                    };
+
+                    auto invoked = [&]<auto... In>(std::index_sequence<In...>)
+                        -> Result
+                    {
+                        using Invoked = std::invoke_result_t<const F&, dispatch::Repeat<In, Word&>...>;
+
+                        if constexpr(std::convertible_to<Invoked, Result>)
+                        {
+                            return std::invoke(funct, words[shared[In]]...);
+                        }
+                        else
+                        {   // Non-propagating return values are discarded.
+                            static_cast<void>(std::invoke(funct, words[shared[In]]...));
+                            return {};
+                        };
+                    }(std::make_index_sequence<arity>{});
+
+                    // Write each word back to its storage, truncated to the operand.
+                    for(auto n = 0uz; n < arity; ++n)
+                    {
+                        if(!spans[n].empty() && shared[n] == n)
+                        {
+                            std::ranges::copy_n(std::bit_cast<std::array<std::byte, sizeof(Word)>>(words[n]).begin(), std::min(spans[n].size(), sizeof(Word)), spans[n].begin());
+                        };
+                    };
+
+                    return invoked;
+                };
+            }, arch.insns.entries[insn.opcode].second);
+        };
+    };
+};
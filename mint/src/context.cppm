@@ -7,6 +7,7 @@ import :memory;
 import :cpu;
 import :stackframe;
 import :arch;
+import :io;
 
 /*** **
  **
@@ -19,11 +20,15 @@ namespace mint
 {
     export template<const auto& arch> struct ProcessContext
     {
-        using CpuPtr    = std::shared_ptr<Cpu<arch>>;
-        using MemoryPtr = std::shared_ptr<Memory>;
+        using CpuPtr     = std::shared_ptr<Cpu<arch>>;
+        using MemoryPtr  = std::shared_ptr<Memory>;
+        using ChannelPtr = std::shared_ptr<Channel>;
 
-        CpuPtr    cpu;
-        MemoryPtr mem;
+        CpuPtr     cpu;
+        MemoryPtr  mem;
+
+        // Buffered guest output.
+        ChannelPtr io;
     };
  
     export template<const auto& arch> struct ThreadContext
@@ -40,9 +45,22 @@ namespace mint
 
         // Returns the local thread data for this thread.
         auto get_data()
-            -> std::shared_ptr<ThreadData>
+            -> ThreadData&
         {
             return this->process->cpu->get_thread_data(this->id);
         };
+
+        // Routes `io::println` on the current host thread to the process output channel, or to stdout without one.
+        auto bind_output()
+            -> void
+        {
+            if(!this->process->io)
+            {
+                io::unbind();
+                return;
+            };
+
+            io::bind(*this->process->io, this->id);
+        };
     };
 };
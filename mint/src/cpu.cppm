@@ -61,9 +61,24 @@ namespace mint
             return it;
         };
 
+        // Zeroes the ip and registers of each thread, keeping their allocations.
+        auto reset()
+            -> void
+        {
+            for(auto& thread: this->threads)
+            {
+                thread.data.ip = 0;
+
+                for(auto& [_, bytes]: thread.data.registers)
+                {
+                    std::ranges::fill(bytes, std::byte{0});
+                };
+            };
+        };
+
         // Returns a threads data by id.
         auto get_thread_data(const std::size_t N)
-            -> ThreadData
+            -> ThreadData&
         {
             return this->threads[N].data;
         }
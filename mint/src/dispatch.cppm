@@ -0,0 +1,466 @@
+export module mint: dispatch;
+
+import std;
+import xxas;
+
+import :memory;
+import :traits;
+import :scalar;
+import :context;
+import :expression;
+import :operand;
+import :instruction;
+import :arch;
+import :wide;
+
+/*** **
+ **
+ **  module:   mint: dispatch
+ **  purpose:  Compile-time generated handler tables, specialized per
+ **            instruction alternative, operand source, and bitness.
+ **
+ *** **/
+
+namespace mint
+{
+    namespace dispatch
+    {   // Maximum count of operands a specialized handler reads; fits a superinstruction of two binary instructions.
+        export constexpr inline std::size_t max_arity = 4uz;
+
+        // Marks an instruction alternative that isn't invocable with words.
+        export constexpr inline std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        // Operand sources a handler is specialized over, ordered by `traits::index`.
+        export constexpr inline std::array sources
+        {
+            traits::Source::Register, traits::Source::Immediate, traits::Source::Memory,
+        };
+
+        // Operand bitnesses a handler is specialized over, ordered by `traits::index`.
+        export constexpr inline std::array bitnesses
+        {
+            traits::Bitness::b8,   traits::Bitness::b16,  traits::Bitness::b32, traits::Bitness::b64,
+            traits::Bitness::b128, traits::Bitness::b256, traits::Bitness::b512,
+        };
+
+        // Count of leading `bitnesses` specialized for `arch`; words up to 64 bits, and wider ones only
+        // up to its widest register, so architectures without wide registers never instantiate `Wide` handlers.
+        export template<const auto& arch> constexpr inline std::size_t widths = []
+        {
+            auto widest = traits::index(traits::Bitness::b64);
+            for(const auto& [_, keyword]: arch.keywords.entries)
+            {
+                auto width = traits::index(keyword.template get_as<traits::Bitness>());
+                if(keyword.template get_as<traits::Source>() == traits::Source::Register && width < bitnesses.size())
+                {
+                    widest = std::max(widest, width);
+                };
+            };
+
+            return widest + 1uz;
+        }();
+
+        // Count of operand source permutations for `max_arity` operands.
+        export constexpr inline std::size_t combinations = []
+        {
+            std::size_t count = 1uz;
+            for(std::size_t n = 0uz; n < max_arity; ++n)
+            {
+                count = count * sources.size();
+            };
+
+            return count;
+        }();
+
+        // Unsigned word an operand of bitness `B` is read as.
+        export template<traits::Bitness B> using Word = std::tuple_element_t<traits::index(B),
+            std::tuple<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t, Wide<128uz>, Wide<256uz>, Wide<512uz>>>;
+
+        // Returns the source of the `n`th operand encoded within a permutation `key`.
+        consteval auto source_at(std::size_t key, const std::size_t n) noexcept
+            -> traits::Source
+        {
+            for(std::size_t i = 0uz; i < n; ++i)
+            {
+                key = key / sources.size();
+            };
+
+            return sources[key % sources.size()];
+        };
+
+        // Returns the bytes an operand of `traits` spans when read as a word of type `W`; its own bitness, or the whole
+        // word if it declares none. Narrower memory operands are zero extended into the word, and truncated when written back.
+        export template<class W> constexpr auto width(const Traits traits) noexcept
+            -> std::size_t
+        {
+            auto index = traits::index(traits.get_as<traits::Bitness>());
+            return index < bitnesses.size() ? std::min(1uz << index, sizeof(W)) : sizeof(W);
+        };
+
+        // Guest memory a memory operand's word is copied from, and the lock of its page.
+        export struct Access
+        {
+            std::uintptr_t       vaddr{};
+            std::span<std::byte> bytes{};
+            mem::Page::Mutex     mutex{};
+        };
+
+        // Locks the page of each access once, in address order, so handlers sharing pages can't deadlock.
+        template<std::size_t N> auto lock(const std::array<Access, N>& accesses)
+            -> std::array<std::unique_lock<mem::RwLock>, N>
+        {
+            std::array<mem::RwLock*, N> mutexes{};
+            std::ranges::transform(accesses, mutexes.begin(), [](const Access& access) { return access.mutex.get(); });
+            std::ranges::sort(mutexes);
+
+            std::array<std::unique_lock<mem::RwLock>, N> locks{};
+            for(auto n = 0uz; n < N; ++n)
+            {
+                if(mutexes[n] && (n == 0uz || mutexes[n] != mutexes[n - 1uz]))
+                {
+                    locks[n] = std::unique_lock(*mutexes[n]);
+                };
+            };
+
+            return locks;
+        };
+
+        template<std::size_t, class T> using Repeat = T;
+
+        template<class F, class W, class Seq> constexpr inline bool invocable_with = false;
+        template<class F, class W, std::size_t... In> constexpr inline bool invocable_with<F, W, std::index_sequence<In...>>
+            = std::invocable<const F&, Repeat<In, W&>...>;
+
+        // Returns the least count of `W&` operands `F` is invocable with, or `npos`.
+        template<class F, class W, std::size_t N = 0uz> consteval auto arity() noexcept
+            -> std::size_t
+        {
+            if constexpr(N > max_arity)
+            {
+                return npos;
+            }
+            else if constexpr(invocable_with<F, W, std::make_index_sequence<N>>)
+            {
+                return N;
+            }
+            else
+            {
+                return arity<F, W, N + 1uz>();
+            };
+        };
+    };
+
+    export template<const auto& arch> struct Dispatch
+    {
+        using Insn = typename std::remove_cvref_t<decltype(arch.insns)>::Insn;
+
+        enum class Err: std::uint8_t
+        {
+            Opcode,
+            Unsupported,
+        };
+
+        using Result  = xxas::Result<void, Err, Operand::Err, Memory::Err>;
+        using Handler = Result(*)(const Instruction&, ThreadContext<arch>&);
+        using Lowered = std::vector<Handler>;
+
+        template<class T> using FindResult = xxas::Result<T, Err>;
+
+        // Count of bitnesses specialized for the architecture.
+        constexpr static inline std::size_t Widths = dispatch::widths<arch>;
+
+        // Count of handlers generated for each instruction alternative.
+        constexpr static inline std::size_t Stride = Widths * dispatch::combinations;
+
+        // Reads an operand from source `S` as a word; immediates are widened into `scratch`.
+        // Memory operands are read through `scratch` as well, once `access` is locked; see `handler`.
+        template<traits::Source S, class W> static auto fetch(const Operand& operand, ThreadContext<arch>& ctx, W& scratch, dispatch::Access& access)
+            -> xxas::Result<W*, Operand::Err, Memory::Err>
+        {
+            if constexpr(S == traits::Source::Register)
+            {   // The register id is the keyword index of the register.
+                auto regid = operand.expression.evaluate<std::size_t>();
+
+                if(regid >= arch.keywords.entries.size())
+                {
+                    return xxas::error(Operand::Err::Uninitialized, "Register id {} is not a keyword", regid);
+                };
+
+                // Keywords that aren't registers have no storage.
+                auto& registers = ctx.get_data().registers;
+                auto  it        = registers.find(arch.keywords.entries[regid].first);
+                auto  size      = it != registers.end() ? it->second.size() : 0uz;
+
+                if(size < sizeof(W))
+                {
+                    return xxas::error(Operand::Err::Casting, "Register of {} bytes is narrower than the handler word", size);
+                };
+
+                return reinterpret_cast<W*>(it->second.data());
+            }
+            else if constexpr(S == traits::Source::Immediate)
+            {
+                auto leaf = operand.expression.constant();
+
+                if(!leaf)
+                {
+                    return xxas::error(Operand::Err::Nonconstant, "Immediate value expects a constant expression");
+                };
+
+                // Widen the immediate, leaving the upper bytes zeroed.
+                std::memcpy(&scratch, leaf->bytes.data(), std::min(sizeof(W), leaf->bytes.size()));
+                return &scratch;
+            }
+            else
+            {   // Guest addresses needn't be aligned to the word, so the handler is only given a copy.
+                auto vaddr        = operand.expression.evaluate<std::uintptr_t>();
+                auto slice_result = ctx.process->mem->slice(vaddr, dispatch::width<W>(operand.traits), Operand::access(operand.traits));
+
+                if(!slice_result)
+                {
+                    return slice_result.error();
+                };
+
+                access = dispatch::Access{.vaddr = vaddr, .bytes = slice_result->span, .mutex = slice_result->mutex};
+                return &scratch;
+            };
+        };
+
+        // Monomorphic handler for alternative `Alt` with operands of bitness `B` read from `S...`.
+        template<std::size_t Alt, traits::Bitness B, traits::Source... S> static auto handler(const Instruction& insn, ThreadContext<arch>& ctx)
+            -> Result
+        {
+            using Word = dispatch::Word<B>;
+
+            const auto& funct = std::get<Alt>(arch.insns.entries[insn.opcode].second);
+
+            // Zeroed storage for widened immediates and copies of memory words, and the memory they're copied from.
+            std::array<Word, sizeof...(S)>             scratch{};
+            std::array<dispatch::Access, sizeof...(S)> accesses{};
+
+            return [&]<auto... In>(std::index_sequence<In...>)
+                -> Result
+            {   // Read each operand straight from its source.
+                std::array<xxas::Result<Word*, Operand::Err, Memory::Err>, sizeof...(S)> words
+                {
+                    Dispatch::fetch<S...[In]>(insn.operands[In], ctx, scratch[In], accesses[In])...
+                };
+
+                // Return the first operand that failed to be read.
+                if(auto it = std::ranges::find_if(words, [](const auto& word) { return !word.has_value(); }); it != words.end())
+                {
+                    return std::move(it->error());
+                };
+
+                // Pages stay locked while their words are copied in, used, and written back.
+                auto locks = dispatch::lock(accesses);
+                auto bound = std::array<Word*, sizeof...(S)>{words[In].value()...};
+
+                for(auto n = 0uz; n < sizeof...(S); ++n)
+                {
+                    auto& bytes = accesses[n].bytes;
+                    if(bytes.empty())
+                    {
+                        continue;
+                    };
+
+                    // Operands of the same memory share a word, as operands of the same register do; it's written back once.
+                    auto alias = n;
+                    for(auto m = 0uz; m < n; ++m)
+                    {
+                        if(accesses[m].bytes.data() == bytes.data() && accesses[m].bytes.size() == bytes.size())
+                        {
+                            alias = m;
+                            break;
+                        };
+                    };
+
+                    if(alias != n)
+                    {
+                        bound[n] = bound[alias];
+                        bytes    = {};
+                        continue;
+                    };
+
+                    std::memcpy(&scratch[n], bytes.data(), bytes.size());
+                };
+
+                using Invoked = std::invoke_result_t<decltype(funct), dispatch::Repeat<In, Word&>...>;
+
+                Result result{};
+                if constexpr(std::convertible_to<Invoked, Result>)
+                {
+                    result = std::invoke(funct, *bound[In]...);
+                }
+                else
+                {   // Non-propagating return values are discarded.
+                    static_cast<void>(std::invoke(funct, *bound[In]...));
+                };
+
+                // Changed words are written back only once every page written grants `Write`, marking it written;
+                // a store to a read-only page faults the instruction without reaching it.
+                std::array<bool, sizeof...(S)> changed{};
+                for(auto n = 0uz; n < sizeof...(S); ++n)
+                {
+                    const auto& [vaddr, bytes, _] = accesses[n];
+                    if(bytes.empty() || std::memcmp(&scratch[n], bytes.data(), bytes.size()) == 0)
+                    {
+                        continue;
+                    };
+
+                    if(auto writable = ctx.process->mem->slice(vaddr, bytes.size(), mem::Flags::Write); !writable)
+                    {
+                        return writable.error();
+                    };
+
+                    changed[n] = true;
+                };
+
+                for(auto n = 0uz; n < sizeof...(S); ++n)
+                {
+                    if(changed[n])
+                    {
+                        std::memcpy(accesses[n].bytes.data(), &scratch[n], accesses[n].bytes.size());
+                    };
+                };
+
+                return result;
+            }(std::make_index_sequence<sizeof...(S)>{});
+        };
+
+        static auto unsupported(const Instruction& insn, ThreadContext<arch>&)
+            -> Result
+        {
+            return xxas::error(Err::Unsupported, "Opcode {} has no specialized handler for its operands", insn.opcode);
+        };
+
+        // Returns the handler at `Key` of the alternative `Alt`; `Key` encodes the bitness and operand sources.
+        template<std::size_t Alt, std::size_t Key> consteval static auto make()
+            -> Handler
+        {
+            constexpr auto bitness = dispatch::bitnesses[Key / dispatch::combinations];
+            constexpr auto arity   = dispatch::arity<std::variant_alternative_t<Alt, Insn>, dispatch::Word<bitness>>();
+
+            if constexpr(arity == dispatch::npos)
+            {
+                return &Dispatch::unsupported;
+            }
+            else
+            {
+                return []<auto... In>(std::index_sequence<In...>)
+                    -> Handler
+                {
+                    return &Dispatch::handler<Alt, bitness, dispatch::source_at(Key % dispatch::combinations, In)...>;
+                }(std::make_index_sequence<arity>{});
+            };
+        };
+
+        // Flattened handler table indexed by alternative, bitness, and operand sources.
+        static auto table() noexcept
+            -> const auto&
+        {
+            constexpr static auto table = []<auto... Key>(std::index_sequence<Key...>)
+            {
+                return std::array<Handler, sizeof...(Key)>
+                {
+                    Dispatch::make<Key / Stride, Key % Stride>()...
+                };
+            }(std::make_index_sequence<std::variant_size_v<Insn> * Stride>{});
+
+            return table;
+        };
+
+        // Operand count of each alternative per bitness; `npos` if it cannot be specialized.
+        static auto arities() noexcept
+            -> const auto&
+        {
+            constexpr static auto arities = []<auto... Key>(std::index_sequence<Key...>)
+            {
+                return std::array<std::size_t, sizeof...(Key)>
+                {
+                    dispatch::arity<std::variant_alternative_t<Key / Widths, Insn>,
+                        dispatch::Word<dispatch::bitnesses[Key % Widths]>>()...
+                };
+            }(std::make_index_sequence<std::variant_size_v<Insn> * Widths>{});
+
+            return arities;
+        };
+
+        // Returns the handler specialized for the instructions opcode, operand sources, and widest operand bitness.
+        static auto find(const Instruction& insn)
+            -> FindResult<Handler>
+        {
+            if(insn.opcode >= arch.insns.entries.size())
+            {
+                return xxas::error(Err::Opcode, "Cannot find a matching function for opcode: {}", insn.opcode);
+            };
+
+            // Encode the operand sources as a permutation key, and find the widest bitness.
+            std::size_t  key     = 0uz;
+            std::size_t  weight  = 1uz;
+            std::uint8_t bitness = 0u;
+
+            for(const auto& operand: insn.operands)
+            {
+                auto source = traits::index(operand.traits.get_as<traits::Source>());
+
+                // Multi-bit sources, such as `Any`, are indexed past the specialized sources.
+                if(source >= dispatch::sources.size())
+                {
+                    return xxas::error(Err::Unsupported, "Opcode {} has an operand without a single source", insn.opcode);
+                };
+
+                key     = key + source * weight;
+                weight  = weight * dispatch::sources.size();
+                bitness = std::max<std::uint8_t>(bitness, operand.traits.get<traits::Bitness>());
+            };
+
+            auto alt   = arch.insns.entries[insn.opcode].second.index();
+            auto width = traits::index(static_cast<traits::Bitness>(bitness));
+
+            if(bitness == 0u || width >= Widths
+                || Dispatch::arities()[alt * Widths + width] != insn.operands.size())
+            {
+                return xxas::error(Err::Unsupported, "Opcode {} has no specialized handler for its operands", insn.opcode);
+            };
+
+            return Dispatch::table()[alt * Stride + width * dispatch::combinations + key];
+        };
+
+        // Lowers a range of instructions into their specialized handlers.
+        static auto lower(const Insns& insns)
+            -> FindResult<Lowered>
+        {
+            Lowered lowered{};
+            lowered.reserve(insns.size());
+
+            for(const auto& insn: insns)
+            {
+                auto handler = Dispatch::find(insn);
+
+                if(!handler)
+                {
+                    return handler.error();
+                };
+
+                lowered.push_back(*handler);
+            };
+
+            return lowered;
+        };
+
+        // Finds and invokes the specialized handler for the instruction.
+        static auto execute(const Instruction& insn, ThreadContext<arch>& ctx)
+            -> Result
+        {
+            auto handler = Dispatch::find(insn);
+
+            if(!handler)
+            {
+                return std::move(handler.error());
+            };
+
+            return std::invoke(*handler, insn, ctx);
+        };
+    };
+};
@@ -3,6 +3,7 @@ export module mint: expression;
 import std;
 import :traits;
 import :scalar;
+import :wide;
 
 /***
  **  module:   mint: expression
@@ -37,13 +38,26 @@ namespace mint
                             +std::mul_sat<T>,
                             +std::div_sat<T>,
                         };
-                    };
-                    return std::array
-                    {   // For any other type use traditional operators.
-                        +[](T a, U b) noexcept(noexcept(a + b)) { return a + b; },
-                        +[](T a, U b) noexcept(noexcept(a - b)) { return a - b; },
-                        +[](T a, U b) noexcept(noexcept(a * b)) { return a * b; },
-                        +[](T a, U b) noexcept(noexcept(a / b)) { return a / b; },
+                    }
+                    else if constexpr(wide::integer<T>)
+                    {   // Wide integers saturate alike.
+                        return std::array
+                        {
+                            +wide::add_sat<T::bits>,
+                            +wide::sub_sat<T::bits>,
+                            +wide::mul_sat<T::bits>,
+                            +wide::div_sat<T::bits>,
+                        };
+                    }
+                    else
+                    {
+                        return std::array
+                        {   // For any other type use traditional operators.
+                            +[](T a, U b) noexcept(noexcept(a + b)) { return a + b; },
+                            +[](T a, U b) noexcept(noexcept(a - b)) { return a - b; },
+                            +[](T a, U b) noexcept(noexcept(a * b)) { return a * b; },
+                            +[](T a, U b) noexcept(noexcept(a / b)) { return a / b; },
+                        };
                     };
                 }()
             };
@@ -56,9 +70,19 @@ namespace mint
         };
 
         export struct Node;
+
+        // Destroys and releases a node through the memory resource that allocated it.
+        export struct Deleter
+        {
+            std::pmr::memory_resource* resource{std::pmr::get_default_resource()};
+
+            void operator()(Node* node) const noexcept;
+        };
+
+        export using NodePtr = std::unique_ptr<Node, Deleter>;
+
         export struct Branch
         {
-            using NodePtr = std::unique_ptr<Node>;
 
             Operator operation;
             NodePtr  left;
@@ -71,13 +95,27 @@ namespace mint
             using std::variant<Leaf, Branch>::variant;
         };
 
+        void Deleter::operator()(Node* node) const noexcept
+        {
+            std::pmr::polymorphic_allocator<Node>{this->resource}.delete_object(node);
+        };
+
+        // Allocates a node from `resource`.
+        export template<class... Args> auto make_node(std::pmr::memory_resource* resource, Args&&... args)
+            -> NodePtr
+        {
+            auto* node = std::pmr::polymorphic_allocator<Node>{resource}.new_object<Node>(std::forward<Args>(args)...);
+            return NodePtr{node, Deleter{resource}};
+        };
+
         export using Tokens = std::vector<std::pair<Scalar, Operator>>;
     };
 
     export struct Expression
     {
         using Node     = expr::Node;
-        using NodePtr  = std::unique_ptr<Node>;
+        using NodePtr  = expr::NodePtr;
+        using Resource = std::pmr::memory_resource;
 
         using Leaf     = expr::Leaf;
         using Branch   = expr::Branch;
@@ -87,9 +125,13 @@ namespace mint
 
         NodePtr root;
 
-        explicit Expression(Leaf&& leaf)     : root(std::make_unique<Node>(std::move(leaf))) {};
-        explicit Expression(Branch&& branch) : root(std::make_unique<Node>(std::move(branch))) {};
-        explicit Expression(NodePtr&& node)  : root(std::move(node)) {};
+        explicit Expression(Leaf&& leaf, Resource* resource = std::pmr::get_default_resource())
+            : root(expr::make_node(resource, std::move(leaf))) {};
+
+        explicit Expression(Branch&& branch, Resource* resource = std::pmr::get_default_resource())
+            : root(expr::make_node(resource, std::move(branch))) {};
+
+        explicit Expression(NodePtr&& node) : root(std::move(node)) {};
 
         constexpr auto constant() const
             -> std::optional<Leaf>
@@ -102,7 +144,7 @@ namespace mint
         };
 
         // Evaluate the expression interpreting scalars as T.
-        template<xxas::meta::arithmetic T> constexpr auto evaluate() const
+        template<class T> requires(xxas::meta::arithmetic<T> || wide::integer<T>) constexpr auto evaluate() const
             -> T
         {
             constexpr auto evaluate_leaf = [](const Leaf& leaf)
@@ -135,7 +177,8 @@ namespace mint
 
         using ParseResult = xxas::Result<Expression, ParseErr>;
 
-        static auto parse(const Tokens& tokens)
+        // Parses the tokens into an expression tree; the tree and its scratch space are allocated from `resource`.
+        static auto parse(const Tokens& tokens, Resource* resource = std::pmr::get_default_resource())
             -> ParseResult
         {
             if (tokens.empty())
@@ -165,10 +208,14 @@ namespace mint
                 };
             };
 
-            std::vector<NodePtr>  nodes{};
-            std::vector<Operator> operators{};
+            std::pmr::vector<NodePtr>  nodes{resource};
+            std::pmr::vector<Operator> operators{resource};
+
+            // Every token yields one leaf, and at most one operator.
+            nodes.reserve(tokens.size());
+            operators.reserve(tokens.size());
 
-            nodes.push_back(std::make_unique<Node>(tokens.front().first));
+            nodes.push_back(expr::make_node(resource, tokens.front().first));
 
             for(auto& [scalar, op]: std::ranges::subrange(tokens.begin() + 1u, tokens.end()))
             {
@@ -177,7 +224,7 @@ namespace mint
                     auto right = std::move(nodes.back()); nodes.pop_back();
                     auto left  = std::move(nodes.back()); nodes.pop_back();
 
-                    nodes.push_back(std::make_unique<Node>(Branch
+                    nodes.push_back(expr::make_node(resource, Branch
                     {
                         operators.back(), std::move(left), std::move(right)
                     }));
@@ -185,7 +232,7 @@ namespace mint
                     operators.pop_back();
                 };
 
-                nodes.push_back(std::make_unique<Node>(scalar));
+                nodes.push_back(expr::make_node(resource, scalar));
                 operators.push_back(op);
             };
 
@@ -194,7 +241,7 @@ namespace mint
                 auto right = std::move(nodes.back()); nodes.pop_back();
                 auto left  = std::move(nodes.back()); nodes.pop_back();
 
-                nodes.push_back(std::make_unique<Node>(Branch
+                nodes.push_back(expr::make_node(resource, Branch
                 {
                     operators.back(), std::move(left), std::move(right)
                 }));
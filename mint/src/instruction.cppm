@@ -20,7 +20,7 @@ namespace mint
 {
     export struct Instruction
     {
-        using Operands  = std::vector<Operand>;
+        using Operands  = std::pmr::vector<Operand>;
         using Opcode    = std::size_t;
 
         Opcode    opcode;
@@ -34,5 +34,55 @@ namespace mint
         };
     };
 
-    export using Insns = std::vector<Instruction>; 
+    export using Insns = std::pmr::vector<Instruction>;
+
+    namespace ir
+    {   // Initial size of a programs monotonic buffer.
+        export constexpr inline std::size_t default_arena_size = 0x4000;
+    };
+
+    // Program IR whose instructions, operands and expression nodes are allocated
+    // from a single monotonic buffer, and released at once on destruction.
+    export struct Program
+    {
+        using Resource  = std::pmr::monotonic_buffer_resource;
+        using Upstream  = std::pmr::memory_resource;
+
+        // Kept behind a pointer so the buffer outlives, and isn't moved beneath, the IR.
+        std::unique_ptr<Resource> resource;
+
+        // Instructions allocated from `resource`.
+        Insns insns;
+
+        explicit Program(const std::size_t size = ir::default_arena_size, Upstream* upstream = std::pmr::new_delete_resource())
+            : resource{std::make_unique<Resource>(size, upstream)}, insns{this->resource.get()} {};
+
+        // Returns the memory resource the IR is allocated from.
+        auto arena() const noexcept
+            -> Resource*
+        {
+            return this->resource.get();
+        };
+
+        // Returns an empty operand range allocated from the arena.
+        auto operands() const
+            -> Instruction::Operands
+        {
+            return Instruction::Operands{this->arena()};
+        };
+
+        // Parses the tokens into an operand expression allocated from the arena.
+        auto expression(const expr::Tokens& tokens) const
+            -> Expression::ParseResult
+        {
+            return Expression::parse(tokens, this->arena());
+        };
+
+        // Appends an instruction; `operands` should be allocated from `operands()`.
+        auto push(const Instruction::Opcode opcode, Instruction::Operands&& operands)
+            -> Instruction&
+        {
+            return this->insns.emplace_back(opcode, std::move(operands));
+        };
+    };
 };
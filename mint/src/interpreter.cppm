@@ -12,17 +12,71 @@ import :binding;
 import :operand;
 import :instruction;
 import :jit_compiler;
+import :io;
 
 namespace mint
 {
     export template<const auto& arch> struct Instance
     {   // Process environment block.
         ProcessContext<arch> inner;
+
+        // Stack frames allocated for the instances threads; a deque, so frames handed out stay in place as more are added.
+        std::deque<StackFrame>  stacks{};
+
+        // Stack frames kept by `reset`; those allocated after the checkpoint are dropped with their memory.
+        std::size_t             kept_stacks{std::numeric_limits<std::size_t>::max()};
+
+        // Allocates a stack frame of `size` bytes, kept with the instance across resets; threads use the frame
+        // through the returned handle, so `reset` empties the frame they push to rather than a copy.
+        auto stack(const std::size_t size = stack::default_size)
+            -> Memory::Result<StackFrame*>
+        {
+            auto alloc_result = this->inner.mem->allocate(size);
+            if(!alloc_result)
+            {
+                return alloc_result.error();
+            };
+
+            return &this->stacks.emplace_back(*alloc_result, size);
+        };
+
+        // Records the instance as `reset` restores it; see `Memory::checkpoint`.
+        auto checkpoint()
+            -> void
+        {
+            this->inner.mem->checkpoint();
+            this->kept_stacks = this->stacks.size();
+        };
+
+        // Returns the instance to its state at the checkpoint, or its freshly built state without freeing any of its
+        // allocations; written pages are restored, registers are cleared, stacks are emptied and pending output is written.
+        auto reset()
+            -> void
+        {
+            this->inner.mem->reset();
+            this->inner.cpu->reset();
+
+            if(this->stacks.size() > this->kept_stacks)
+            {
+                this->stacks.erase(this->stacks.begin() + static_cast<std::ptrdiff_t>(this->kept_stacks), this->stacks.end());
+            };
+
+            for(auto& stack: this->stacks)
+            {
+                stack.reset();
+            };
+
+            if(this->inner.io)
+            {
+                this->inner.io->flush();
+            };
+        };
     };
 
     export template<const auto& arch> struct InstanceBuilder
     {
         MemoryDescriptor mem_desc{};
+        io::Mode         io_mode{io::Mode::Unordered};
 
         // Provide a MemoryDescriptor to tell the Instance where to initialize
         // virtual memory and page widths.
@@ -33,17 +87,147 @@ namespace mint
             return *this;
         };
 
-        // Builds a new process instance, including a virtual CPU and Memory handler.
+        // Provide the order guest output of multiple threads is written in.
+        constexpr auto output(io::Mode io_mode)
+            -> InstanceBuilder
+        {
+            this->io_mode = io_mode;
+            return *this;
+        };
+
+        // Builds a new process instance, including a virtual CPU, Memory handler, and output channel.
         constexpr auto build()
             -> Instance<arch>
         {
             auto vcpu  = std::make_shared<Cpu<arch>>();
-            auto mem  = std::make_shared<Memory>(this->mem_desc.base_addr, this->mem_desc.page_size);
+            auto mem   = std::make_shared<Memory>(this->mem_desc.base_addr, this->mem_desc.page_size);
+            auto io    = std::make_shared<Channel>(this->io_mode);
 
             return Instance
             {
-                .inner = ProcessContext(std::move(vcpu), std::move(mem)),
+                .inner = ProcessContext(std::move(vcpu), std::move(mem), std::move(io)),
             };
         };
     };
+
+    export template<const auto& arch> struct InstancePool
+    {
+        using InstancePtr = std::unique_ptr<Instance<arch>>;
+        using InstanceVec = std::vector<InstancePtr>;
+
+        // Runs once per instance when it's built, e.g. to allocate stacks or map files; its effects are checkpointed,
+        // so each job starts from them.
+        using Setup = std::function<void(Instance<arch>&)>;
+
+        // Instance checked out of the pool; reset and returned to the pool when destroyed.
+        struct Lease
+        {
+            InstancePool* pool{};
+            InstancePtr   instance{};
+
+            Lease(InstancePool* pool, InstancePtr instance)
+                : pool{pool}, instance{std::move(instance)} {};
+
+            Lease(Lease&& other) noexcept
+                : pool{std::exchange(other.pool, nullptr)}, instance{std::move(other.instance)} {};
+
+            Lease(const Lease&) = delete;
+
+            ~Lease()
+            {
+                if(this->pool && this->instance)
+                {
+                    this->pool->release(std::move(this->instance));
+                };
+            };
+
+            auto operator->() const noexcept
+                -> Instance<arch>*
+            {
+                return this->instance.get();
+            };
+
+            auto operator*() const noexcept
+                -> Instance<arch>&
+            {
+                return *this->instance;
+            };
+        };
+
+        InstanceBuilder<arch> builder;
+        Setup                 setup;
+
+        // Locks the idle instances.
+        std::mutex            mutex{};
+
+        // Built instances, ready to be acquired.
+        InstanceVec           idle{};
+
+        explicit InstancePool(InstanceBuilder<arch> builder = {}, Setup setup = {})
+            : builder{std::move(builder)}, setup{std::move(setup)} {};
+
+        // Builds `count` instances ahead of time, so acquiring them never allocates.
+        auto reserve(const std::size_t count)
+            -> void
+        {
+            InstanceVec built{};
+            built.reserve(count);
+
+            for(auto n = 0uz; n < count; ++n)
+            {
+                built.push_back(this->make());
+            };
+
+            std::scoped_lock lock(this->mutex);
+            this->idle.reserve(this->idle.size() + count);
+
+            for(auto& instance: built)
+            {
+                this->idle.push_back(std::move(instance));
+            };
+        };
+
+        // Hands out an idle instance, building one if none are available.
+        auto acquire()
+            -> Lease
+        {
+            {
+                std::scoped_lock lock(this->mutex);
+                if(!this->idle.empty()) [[likely]]
+                {
+                    auto instance = std::move(this->idle.back());
+                    this->idle.pop_back();
+
+                    return Lease(this, std::move(instance));
+                };
+            };
+
+            return Lease(this, this->make());
+        };
+
+        // Resets an instance and returns it to the pool.
+        auto release(InstancePtr instance)
+            -> void
+        {
+            instance->reset();
+
+            std::scoped_lock lock(this->mutex);
+            this->idle.push_back(std::move(instance));
+        };
+
+        // Builds and sets up a new instance.
+        auto make()
+            -> InstancePtr
+        {
+            auto instance = std::make_unique<Instance<arch>>(this->builder.build());
+
+            if(this->setup)
+            {
+                std::invoke(this->setup, *instance);
+            };
+
+            instance->checkpoint();
+            return instance;
+        };
+    };
 };
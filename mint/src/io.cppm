@@ -0,0 +1,384 @@
+module;
+#include <sys/uio.h>
+#include <unistd.h>
+#include <climits>
+#include <cerrno>
+
+export module mint: io;
+
+import std;
+import xxas;
+
+#ifndef IOV_MAX
+  #define IOV_MAX 1024
+#endif
+
+/*** **
+ **
+ **  module:   mint: io
+ **  purpose:  Buffered guest output channel; per-thread buffers flushed
+ **            in batches by a background writer.
+ **
+ *** **/
+
+namespace mint
+{
+    namespace io
+    {   // Order output is written in across guest threads.
+        export enum class Mode: std::uint8_t
+        {   // Each threads batch is written contiguously.
+            Unordered,
+
+            // Lines are written in the order they were produced.
+            Ordered,
+        };
+
+        // Buffered bytes of a thread that wake the writer early.
+        export constexpr inline std::size_t default_threshold = 0x1000;
+
+        // Interval between background flushes.
+        export constexpr inline std::chrono::milliseconds default_interval{10};
+
+        // Per-thread output buffer.
+        export struct Buffer
+        {   // Sequence number and end offset of each line.
+            using Line  = std::pair<std::uint64_t, std::size_t>;
+            using Lines = std::vector<Line>;
+
+            // Only contended while the writer drains the buffer.
+            std::mutex  mutex{};
+            std::string bytes{};
+            Lines       lines{};
+        };
+
+        export enum class Err: std::uint8_t
+        {
+            Write,
+        };
+
+        export template<class T = std::void_t<>> using Result = xxas::Result<T, Err>;
+
+        // Writes every byte of the io vectors to `fd`, retrying partial and interrupted writes.
+        auto write_all(const int fd, std::span<iovec> iov)
+            -> Result<>
+        {
+            while(!iov.empty())
+            {
+                auto written = ::writev(fd, iov.data(), static_cast<int>(std::min<std::size_t>(iov.size(), IOV_MAX)));
+
+                if(written < 0)
+                {
+                    if(errno == EINTR)
+                    {
+                        continue;
+                    };
+
+                    return xxas::error(Err::Write, "cannot write guest output (errno {})", errno);
+                };
+
+                // Skip fully written vectors, and advance into a partially written one.
+                auto remaining = static_cast<std::size_t>(written);
+                while(!iov.empty() && remaining >= iov.front().iov_len)
+                {
+                    remaining = remaining - iov.front().iov_len;
+                    iov       = iov.subspan(1uz);
+                };
+
+                if(!iov.empty())
+                {
+                    iov.front().iov_base = static_cast<char*>(iov.front().iov_base) + remaining;
+                    iov.front().iov_len  = iov.front().iov_len - remaining;
+                };
+            };
+
+            return {};
+        };
+    };
+
+    export struct Channel
+    {
+        using BufferPtr = std::unique_ptr<io::Buffer>;
+        using BufferVec = std::vector<BufferPtr>;
+
+        // Output file descriptor.
+        int                       fd;
+        io::Mode                  mode;
+        std::size_t               threshold;
+        std::chrono::milliseconds interval;
+
+        // Next line sequence number.
+        std::atomic_uint64_t      sequence{};
+
+        // Buffers indexed by thread id.
+        BufferVec                 buffers{};
+
+        // Locks during buffer registration.
+        std::shared_mutex         mutex{};
+
+        // Serializes draining and writing buffers.
+        std::mutex                flushing{};
+
+        // Ordered lines drained, but held back until every line before them is written; locked by `flushing`.
+        std::vector<std::pair<std::uint64_t, std::string>> held{};
+
+        // First write error not yet taken by `error`, including those of background flushes; locked by `flushing`.
+        std::optional<xxas::Error<io::Err>> failed{};
+
+        // Wakes the writer before its interval elapses.
+        std::mutex                wake_mutex{};
+        std::condition_variable_any wake{};
+        std::atomic_bool          requested{};
+
+        // Background writer; declared last so it stops before the state above is destroyed.
+        std::jthread              writer{};
+
+        explicit Channel(const io::Mode mode = io::Mode::Unordered, const int fd = STDOUT_FILENO,
+            const std::size_t threshold = io::default_threshold, const std::chrono::milliseconds interval = io::default_interval)
+            : fd{fd}, mode{mode}, threshold{threshold}, interval{interval}
+        {
+            this->writer = std::jthread([this](std::stop_token token)
+            {
+                while(!token.stop_requested())
+                {
+                    {
+                        std::unique_lock lock(this->wake_mutex);
+                        this->wake.wait_for(lock, token, this->interval, [this]
+                        {
+                            return this->requested.load(std::memory_order_relaxed);
+                        });
+                    };
+
+                    this->requested.store(false, std::memory_order_relaxed);
+                    this->flush();
+                };
+            });
+        };
+
+        ~Channel()
+        {   // Stop the writer, then write anything still buffered.
+            this->writer.request_stop();
+
+            if(this->writer.joinable())
+            {
+                this->writer.join();
+            };
+
+            this->flush();
+        };
+
+        // Returns the buffer for thread `id`, registering it if needed.
+        auto buffer(const std::size_t id)
+            -> io::Buffer&
+        {
+            {
+                std::shared_lock lock(this->mutex);
+                if(id < this->buffers.size() && this->buffers[id]) [[likely]]
+                {
+                    return *this->buffers[id];
+                };
+            };
+
+            std::unique_lock lock(this->mutex);
+            if(id >= this->buffers.size())
+            {
+                this->buffers.resize(id + 1uz);
+            };
+
+            if(!this->buffers[id])
+            {
+                this->buffers[id] = std::make_unique<io::Buffer>();
+            };
+
+            return *this->buffers[id];
+        };
+
+        // Appends a line to the buffer of thread `id` through `funct`.
+        template<class F> auto append(const std::size_t id, F&& funct)
+            -> void
+        {
+            auto& buffer = this->buffer(id);
+            auto  size   = 0uz;
+            {
+                std::scoped_lock lock(buffer.mutex);
+
+                std::invoke(std::forward<F>(funct), buffer.bytes);
+                buffer.lines.emplace_back(this->sequence.fetch_add(1u, std::memory_order_relaxed), buffer.bytes.size());
+
+                size = buffer.bytes.size();
+            };
+
+            // Wake the writer once a buffer crosses the threshold.
+            if(size >= this->threshold && !this->requested.exchange(true, std::memory_order_relaxed))
+            {
+                { std::scoped_lock lock(this->wake_mutex); };
+                this->wake.notify_one();
+            };
+        };
+
+        // Writes `text` as a line of thread `id`.
+        auto write(const std::size_t id, const std::string_view text)
+            -> void
+        {
+            this->append(id, [&text](std::string& bytes)
+            {
+                bytes.append(text);
+                bytes.push_back('\n');
+            });
+        };
+
+        // Formats a line of thread `id` directly into its buffer.
+        template<class... Args> auto println(const std::size_t id, std::format_string<Args...> fmt, Args&&... args)
+            -> void
+        {
+            this->append(id, [&](std::string& bytes)
+            {
+                std::format_to(std::back_inserter(bytes), fmt, std::forward<Args>(args)...);
+                bytes.push_back('\n');
+            });
+        };
+
+        // Returns the first write error since last called, and clears it.
+        auto error()
+            -> std::optional<xxas::Error<io::Err>>
+        {
+            std::scoped_lock lock(this->flushing);
+            return std::exchange(this->failed, std::nullopt);
+        };
+
+        // Drains every buffer and writes its lines in a single batch; a batch that fails to write is dropped, and
+        // its error is also kept for `error`.
+        auto flush()
+            -> io::Result<>
+        {
+            std::scoped_lock lock(this->flushing);
+
+            // Lines are numbered under their buffer's lock, so each line numbered below the watermark is in its
+            // buffer once drained. Lines from it on may follow lines appended to buffers already drained.
+            auto watermark = this->sequence.load(std::memory_order_relaxed);
+
+            // Take ownership of the pending output, releasing each buffer as soon as possible.
+            std::vector<std::pair<std::string, io::Buffer::Lines>> drained{};
+            {
+                std::shared_lock buffers_lock(this->mutex);
+                for(auto& buffer: this->buffers)
+                {
+                    if(!buffer)
+                    {
+                        continue;
+                    };
+
+                    std::scoped_lock buffer_lock(buffer->mutex);
+                    if(!buffer->bytes.empty())
+                    {
+                        drained.emplace_back(std::exchange(buffer->bytes, {}), std::exchange(buffer->lines, {}));
+                    };
+                };
+            };
+
+            std::vector<iovec> iov{};
+            std::vector<std::pair<std::uint64_t, std::string>> held{};
+
+            if(this->mode == io::Mode::Unordered)
+            {
+                for(auto& [bytes, _]: drained)
+                {
+                    iov.push_back(iovec{bytes.data(), bytes.size()});
+                };
+            }
+            else
+            {   // Merge the held lines, and the lines of every buffer, by their sequence number.
+                std::vector<std::pair<std::uint64_t, std::span<char>>> lines{};
+                for(auto& [sequence, line]: this->held)
+                {
+                    lines.emplace_back(sequence, std::span(line));
+                };
+
+                for(auto& [bytes, ends]: drained)
+                {
+                    auto begin = 0uz;
+                    for(const auto& [sequence, end]: ends)
+                    {
+                        lines.emplace_back(sequence, std::span(bytes.data() + begin, end - begin));
+                        begin = end;
+                    };
+                };
+
+                std::ranges::sort(lines, {}, &decltype(lines)::value_type::first);
+
+                // Hold lines from the watermark on for the next flush.
+                auto split = std::ranges::lower_bound(lines, watermark, {}, &decltype(lines)::value_type::first);
+                for(const auto& [sequence, line]: std::ranges::subrange(split, lines.end()))
+                {
+                    held.emplace_back(sequence, std::string(line.begin(), line.end()));
+                };
+
+                lines.erase(split, lines.end());
+
+                for(const auto& [_, line]: lines)
+                {   // Extend the previous vector over adjacent lines of the same buffer.
+                    if(!iov.empty() && static_cast<char*>(iov.back().iov_base) + iov.back().iov_len == line.data())
+                    {
+                        iov.back().iov_len = iov.back().iov_len + line.size();
+                        continue;
+                    };
+
+                    iov.push_back(iovec{line.data(), line.size()});
+                };
+            };
+
+            auto written = io::write_all(this->fd, iov);
+            this->held   = std::move(held);
+
+            if(!written && !this->failed)
+            {
+                this->failed = written.error();
+            };
+
+            return written;
+        };
+    };
+
+    namespace io
+    {
+        struct Current
+        {
+            Channel*    channel{};
+            std::size_t id{};
+        };
+
+        // Channel the current host thread writes guest output to.
+        auto current() noexcept
+            -> Current&
+        {
+            thread_local Current current{};
+            return current;
+        };
+
+        // Binds the current host thread to the channel as guest thread `id`.
+        export auto bind(Channel& channel, const std::size_t id) noexcept
+            -> void
+        {
+            current() = Current{&channel, id};
+        };
+
+        // Unbinds the current host thread, writing its guest output directly to stdout.
+        export auto unbind() noexcept
+            -> void
+        {
+            current() = Current{};
+        };
+
+        // Writes a guest output line through the bound channel, or directly to stdout if unbound.
+        export template<class... Args> auto println(std::format_string<Args...> fmt, Args&&... args)
+            -> void
+        {
+            if(auto& [channel, id] = current(); channel != nullptr)
+            {
+                channel->println(id, fmt, std::forward<Args>(args)...);
+                return;
+            };
+
+            std::println(fmt, std::forward<Args>(args)...);
+        };
+    };
+};
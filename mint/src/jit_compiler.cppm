@@ -26,7 +26,7 @@ namespace mint
         };
 
         // Jit compiler input instructions.
-        using Input = std::vector<Instruction>;
+        using Input = Insns;
 
         // Jit compiler output bindings.
         using Output = std::vector<Binding>;
@@ -35,8 +35,10 @@ namespace mint
         // Just-in-time compiles loose instruction information into direct function calls for a thread.
         template<const auto& arch> constexpr static auto from(const Input& input, const ThreadContext<arch>& ctx)
             -> Result
-        {   // JIT output bindings.
+        {   // JIT output bindings; one per instruction.
             Output output{};
+            output.reserve(input.size());
+
             for(const auto& insn: input)
             {   // Evaluate each operand.
                 auto results = std::ranges::transform(insn.operands, [&](Operand& operand)
@@ -61,7 +63,7 @@ namespace mint
 
                 if(funct_it == arch.insns.cend())
                 {
-                    return xxas::error(Err::Missing, std::format("Cannot find a matching function for opcode: {}", insn.opcode));
+                    return xxas::error(Err::Missing, "Cannot find a matching function for opcode: {}", insn.opcode);
                 };
 
                 // Create a new binding for the function.
@@ -1,5 +1,10 @@
 module;
 #include <experimental/simd>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 
 export module mint: memory;
 
@@ -42,33 +47,140 @@ namespace mint
             Default   = Rw,
         };
 
+        // Returns if `flags` grants every permission within `access`.
+        export constexpr auto permits(const Flags flags, const Flags access) noexcept
+            -> bool
+        {
+            return (std::to_underlying(flags) & std::to_underlying(access)) == std::to_underlying(access);
+        };
+
+        // Reader-writer lock, optionally shareable between host processes when placed in shared memory.
+        export struct RwLock
+        {
+            pthread_rwlock_t inner;
+
+            explicit RwLock(const bool shared = false) noexcept
+            {
+                pthread_rwlockattr_t attr;
+                ::pthread_rwlockattr_init(&attr);
+                ::pthread_rwlockattr_setpshared(&attr, shared ? PTHREAD_PROCESS_SHARED : PTHREAD_PROCESS_PRIVATE);
+                ::pthread_rwlock_init(&this->inner, &attr);
+                ::pthread_rwlockattr_destroy(&attr);
+            };
+
+            RwLock(const RwLock&) = delete;
+
+            ~RwLock()
+            {
+                ::pthread_rwlock_destroy(&this->inner);
+            };
+
+            auto lock() noexcept
+                -> void
+            {
+                ::pthread_rwlock_wrlock(&this->inner);
+            };
+
+            auto try_lock() noexcept
+                -> bool
+            {
+                return ::pthread_rwlock_trywrlock(&this->inner) == 0;
+            };
+
+            auto unlock() noexcept
+                -> void
+            {
+                ::pthread_rwlock_unlock(&this->inner);
+            };
+
+            auto lock_shared() noexcept
+                -> void
+            {
+                ::pthread_rwlock_rdlock(&this->inner);
+            };
+
+            auto try_lock_shared() noexcept
+                -> bool
+            {
+                return ::pthread_rwlock_tryrdlock(&this->inner) == 0;
+            };
+
+            auto unlock_shared() noexcept
+                -> void
+            {
+                ::pthread_rwlock_unlock(&this->inner);
+            };
+        };
+
         export struct Page
         {
-            using Mutex = std::shared_ptr<std::shared_mutex>;
+            using Mutex   = std::shared_ptr<RwLock>;
+            using Dirty   = std::shared_ptr<std::atomic_bool>;
+            using Mapping = std::shared_ptr<std::byte>;
+
+            // Lock and write tracking of a page, shared by a single allocation.
+            struct State
+            {
+                RwLock           mutex{};
+                std::atomic_bool dirty{};
+            };
 
             std::uintptr_t vaddr;
             std::size_t    size;
             Flags          flags;
             Mutex          mutex;
 
-            constexpr Page(const std::uintptr_t vaddr, const std::size_t size, const Flags flags = Flags::Rw)
-                :vaddr{vaddr}, size{size}, flags{flags}, mutex{std::make_shared<std::shared_mutex>()} {};
+            // Set once the page is written; cleared by `Memory::reset`.
+            Dirty          dirty;
+
+            // Host mapping backing the page; pages without one are backed by `Memory::bytes`.
+            // Pages of a shared address space alias their mapping, mutex and dirty flag into the shared region.
+            Mapping        mapping;
+
+            constexpr Page(const std::uintptr_t vaddr, const std::size_t size, const Flags flags = Flags::Rw, Mapping mapping = {})
+                :vaddr{vaddr}, size{size}, flags{flags}, mapping{std::move(mapping)}
+            {   // Alias the mutex and dirty flag into the shared state.
+                auto state  = std::make_shared<State>();
+                this->mutex = Mutex(state, &state->mutex);
+                this->dirty = Dirty(state, &state->dirty);
+            };
 
-            // Returns if the address provided is within the pages bounds.
+            // Returns if the address provided is within the pages bounds; the end belongs to the next page.
             constexpr auto contains(const std::uintptr_t vaddr)
             {
-                return this->vaddr <= vaddr && (this->vaddr + this->size) >= vaddr;
+                return this->vaddr <= vaddr && vaddr < (this->vaddr + this->size);
             };
         };
 
+        // Errors of atomic accesses to a slice.
+        export enum class AtomicErr: std::uint8_t
+        {
+            OutOfRange,
+            Misaligned,
+        };
+
         // Thread-safe non-owning shared page memory slice container.
         export template<class T> struct Shared
         {
-            using Mutex = std::shared_ptr<std::shared_mutex>;
+            using Mutex = std::shared_ptr<RwLock>;
+            using Dirty = std::shared_ptr<std::atomic_bool>;
             using Span  = std::span<T>;
 
+            template<class R = std::void_t<>> using Result = xxas::Result<R, AtomicErr>;
+
             Span  span;
             Mutex mutex;
+            Dirty dirty{};
+
+            // Marks the page as written; checked first to keep the flag read-mostly.
+            auto mark() const noexcept
+                -> void
+            {
+                if(this->dirty && !this->dirty->load(std::memory_order_relaxed))
+                {
+                    this->dirty->store(true, std::memory_order_relaxed);
+                };
+            };
 
             template<class O> constexpr Shared<O> as() const
             {
@@ -79,7 +191,8 @@ namespace mint
                         reinterpret_cast<O*>(this->span.data()),
                         this->span.size_bytes() / sizeof(O)
                     },
-                    .mutex = this->mutex
+                    .mutex = this->mutex,
+                    .dirty = this->dirty,
                 };
             };
 
@@ -89,7 +202,8 @@ namespace mint
                 return Shared<O>
                 {
                     .span = std::span<O>(reinterpret_cast<O*>(sub.data()), sub.size_bytes() / sizeof(O)),
-                    .mutex = this->mutex
+                    .mutex = this->mutex,
+                    .dirty = this->dirty,
                 };
             };
 
@@ -106,7 +220,8 @@ namespace mint
                   return Shared<Simd>
                   {
                       .span = std::span<Simd>(data, count),
-                      .mutex = this->mutex
+                      .mutex = this->mutex,
+                      .dirty = this->dirty,
                   };
               };
             #endif
@@ -120,6 +235,8 @@ namespace mint
             template<class F> auto exclusive(F&& funct)
             {
                 std::unique_lock lock(*this->mutex);
+                this->mark();
+
                 return std::invoke(std::forward<F>(funct), this->span);
             };
 
@@ -157,10 +274,200 @@ namespace mint
                     return bytes_to_copy - src_bytes;
                 });
             };
+
+            // Lock-free access to the elements, bypassing the page mutex.
+            // Guest atomics follow the C++ memory model; an element accessed atomically must
+            // never be accessed through `shared` or `exclusive` concurrently.
+
+            // Returns an atomic reference to the element at `index`, which must be in range and meet `required_alignment`.
+            auto atomic(const std::size_t index = 0uz) const
+                -> Result<std::atomic_ref<T>>
+            {
+                if(index >= this->span.size())
+                {
+                    return xxas::error(AtomicErr::OutOfRange, "Element {} is out of range", index);
+                };
+
+                if(!this->is_atomic(index))
+                {
+                    return xxas::error(AtomicErr::Misaligned, "Element {} isn't aligned for atomic access", index);
+                };
+
+                return std::atomic_ref<T>(this->span[index]);
+            };
+
+            // Returns if the element at `index` can be accessed atomically.
+            auto is_atomic(const std::size_t index = 0uz) const noexcept
+                -> bool
+            {
+                return index < this->span.size()
+                    && reinterpret_cast<std::uintptr_t>(this->span.data() + index) % std::atomic_ref<T>::required_alignment == 0uz;
+            };
+
+            // Invokes `funct` on the atomic reference to the element at `index`; writes mark the page once checked.
+            template<bool Write, class F> auto atomically(const std::size_t index, F&& funct) const
+                -> Result<std::invoke_result_t<F, std::atomic_ref<T>>>
+            {
+                auto ref = this->atomic(index);
+                if(!ref)
+                {
+                    return ref.error();
+                };
+
+                if constexpr(Write)
+                {
+                    this->mark();
+                };
+
+                if constexpr(std::is_void_v<std::invoke_result_t<F, std::atomic_ref<T>>>)
+                {
+                    std::invoke(std::forward<F>(funct), *ref);
+                    return {};
+                }
+                else
+                {
+                    return std::invoke(std::forward<F>(funct), *ref);
+                };
+            };
+
+            auto load(const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<T>
+            {
+                return this->template atomically<false>(index, [order](auto ref) { return ref.load(order); });
+            };
+
+            auto store(const T value, const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<>
+            {
+                return this->template atomically<true>(index, [=](auto ref) { ref.store(value, order); });
+            };
+
+            auto exchange(const T value, const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<T>
+            {
+                return this->template atomically<true>(index, [=](auto ref) { return ref.exchange(value, order); });
+            };
+
+            // Replaces the element with `desired` if it equals `expected`; otherwise loads it into `expected`.
+            auto compare_exchange(T& expected, const T desired, const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<bool>
+            {
+                return this->template atomically<true>(index, [&](auto ref) { return ref.compare_exchange_strong(expected, desired, order); });
+            };
+
+            auto fetch_add(const T value, const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<T>
+                requires std::integral<T>
+            {
+                return this->template atomically<true>(index, [=](auto ref) { return ref.fetch_add(value, order); });
+            };
+
+            auto fetch_sub(const T value, const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<T>
+                requires std::integral<T>
+            {
+                return this->template atomically<true>(index, [=](auto ref) { return ref.fetch_sub(value, order); });
+            };
+
+            auto fetch_and(const T value, const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<T>
+                requires std::integral<T>
+            {
+                return this->template atomically<true>(index, [=](auto ref) { return ref.fetch_and(value, order); });
+            };
+
+            auto fetch_or(const T value, const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<T>
+                requires std::integral<T>
+            {
+                return this->template atomically<true>(index, [=](auto ref) { return ref.fetch_or(value, order); });
+            };
+
+            auto fetch_xor(const T value, const std::memory_order order = std::memory_order_seq_cst, const std::size_t index = 0uz) const
+                -> Result<T>
+                requires std::integral<T>
+            {
+                return this->template atomically<true>(index, [=](auto ref) { return ref.fetch_xor(value, order); });
+            };
+
+            // Orders surrounding guest memory accesses without an associated element.
+            static auto fence(const std::memory_order order = std::memory_order_seq_cst) noexcept
+                -> void
+            {
+                std::atomic_thread_fence(order);
+            };
         };
 
         export constexpr inline std::size_t default_base_addr  = 0x2000;
         export constexpr inline std::size_t default_page_size  = 0x1000;
+
+        // Offset from the base address that file mappings are placed at, apart from allocations.
+        export constexpr inline std::size_t default_map_offset = 0x100000000000;
+
+        // Layout of an address space placed in a named POSIX shared memory object.
+        namespace shm
+        {   // Identifies an initialized shared address space.
+            export constexpr inline std::uint64_t magic = 0x6d69'6e74'2d73'686d;
+
+            // Pages a shared address space can hold.
+            export constexpr inline std::size_t max_pages = 0x400;
+
+            // Default bytes of guest memory in a shared address space.
+            export constexpr inline std::size_t default_capacity = 0x100000;
+
+            // Shared page metadata; every field is valid across processes.
+            export struct Entry
+            {
+                std::uintptr_t     vaddr{};
+                std::size_t        size{};
+                Flags              flags{};
+                std::atomic_bool   dirty{};
+                RwLock             lock{true};
+
+                // Guest bytes reserved by the entry, which later allocations reuse once it's released.
+                std::uintptr_t     base{};
+                std::size_t        extent{};
+
+                // Cleared once the page is freed; the entry is released when no writable attachment holds it anymore.
+                std::atomic_bool   live{};
+                std::atomic_size_t holders{};
+
+                // Incremented each time the entry is published, telling a reused entry apart from the page it held.
+                std::atomic_size_t generation{};
+            };
+
+            // Placed at the start of the region, followed by the guest bytes at `data_offset`.
+            export struct Header
+            {   // Written last by the creator; attaching processes check it.
+                std::atomic_uint64_t  magic{};
+
+                std::uintptr_t        base_addr;
+                std::size_t           page_size;
+                std::size_t           capacity;
+
+                // Next free address, and number of entries ever published.
+                std::atomic_uintptr_t next_addr;
+                std::atomic_size_t    count{};
+
+                // Incremented whenever an entry is published, so attachments know to sync.
+                std::atomic_size_t    epoch{};
+
+                // Serializes page allocation between processes.
+                RwLock                lock{true};
+
+                std::array<Entry, max_pages> entries{};
+
+                Header(const std::uintptr_t base_addr, const std::size_t page_size, const std::size_t capacity)
+                    : base_addr{base_addr}, page_size{page_size}, capacity{capacity}, next_addr{base_addr} {};
+            };
+
+            // Offset of the guest bytes from the start of the region, aligned to the page size.
+            export constexpr auto data_offset(const std::size_t page_size) noexcept
+                -> std::size_t
+            {
+                return (sizeof(Header) + page_size - 1uz) / page_size * page_size;
+            };
+        };
     };
 
     export struct MemoryDescriptor
@@ -175,11 +482,15 @@ namespace mint
         using PageVec   = std::vector<mem::Page>;
         using BytesVec  = std::vector<std::byte>;
         using FreeVec   = std::vector<VMSpan>;
+        using Region    = std::shared_ptr<mem::shm::Header>;
 
         // Next free address.
         std::atomic_uintptr_t next_addr;
         std::uintptr_t        base_addr;
 
+        // Next free address for file mappings.
+        std::atomic_uintptr_t next_map_addr;
+
         // Page mutexes and flags.
         PageVec               pages;
 
@@ -192,36 +503,273 @@ namespace mint
         // Size of a memory page.
         std::size_t           page_size;
 
-        // Locks during resizing operations.
-        std::mutex            mutex;
+        // Locks `pages` and `bytes`; held exclusively while resizing either, shared during lookups.
+        std::shared_mutex     mutex;
+
+        // Shared memory region holding the address space, if placed in one.
+        Region                region{};
+
+        // Permissions this process mapped the region with.
+        mem::Flags            region_access{mem::Flags::Rw};
+
+        // Shared page entry mirrored into `pages`; a generation of zero if none is.
+        struct Held
+        {
+            std::size_t    generation{};
+            std::uintptr_t vaddr{};
+        };
+
+        // Region epoch last mirrored into `pages`, and the entries mirrored, by index.
+        std::size_t           synced{};
+        std::vector<Held>     held{};
+
+        // Address space state `reset` rolls back to; see `checkpoint`.
+        struct Snapshot
+        {
+            std::uintptr_t next_addr;
+            std::uintptr_t next_map_addr;
+            PageVec        pages;
+            FreeVec        freed;
+            BytesVec       bytes;
+
+            // Contents of pages backed by a host mapping, by index into `pages`; empty if the page reverts to zeroes or its file.
+            std::vector<BytesVec> mapped;
+        };
+
+        std::optional<Snapshot> snapshot{};
 
         enum class Err: std::uint8_t
         {
             OutOfRange,
             NoPermission,
+            Mapping,
         };
 
         template<class T> using Result = xxas::Result<T, Err>;
 
         constexpr Memory(const std::uintptr_t base_addr = mem::default_base_addr, const std::size_t page_sz = mem::default_page_size)
-            : next_addr(base_addr), page_size(page_sz), base_addr(base_addr)
+            : next_addr(base_addr), base_addr(base_addr), next_map_addr(base_addr + mem::default_map_offset), page_size(page_sz)
         {
             bytes.reserve(1024 * 1024);
         };
 
+        // Address space held by a shared memory region; see `create_shared` and `attach_shared`.
+        Memory(Region region, const mem::Flags access)
+            : next_addr(region->base_addr), base_addr(region->base_addr), next_map_addr(region->base_addr + mem::default_map_offset),
+              page_size(region->page_size), region{std::move(region)}, region_access{access}
+        {
+            this->sync();
+        };
+
+        // Detaching drops the holds on shared pages; those already freed elsewhere are released with the last one.
+        ~Memory()
+        {
+            if(!this->region || !mem::permits(this->region_access, mem::Flags::Write))
+            {
+                return;
+            };
+
+            for(auto&& [entry, hold]: std::views::zip(this->region->entries, this->held))
+            {
+                if(hold.generation != 0uz)
+                {
+                    entry.holders.fetch_sub(1uz, std::memory_order_acq_rel);
+                };
+            };
+        };
+
+        // Creates an address space in the named POSIX shared memory object `name`, with `capacity` bytes of guest memory.
+        // Other host processes may attach to it while the returned memory is alive; the name is unlinked with it.
+        static auto create_shared(const std::string& name, const std::size_t capacity = mem::shm::default_capacity, const MemoryDescriptor desc = {})
+            -> Result<std::shared_ptr<Memory>>
+        {
+            auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+            if(fd < 0)
+            {
+                return xxas::error(Err::Mapping, "cannot create shared memory object (errno {})", errno);
+            };
+
+            auto size = mem::shm::data_offset(desc.page_size) + capacity;
+            if(::ftruncate(fd, static_cast<off_t>(size)) != 0)
+            {
+                auto failed = errno;
+                ::close(fd);
+                ::shm_unlink(name.c_str());
+
+                return xxas::error(Err::Mapping, "cannot size shared memory object (errno {})", failed);
+            };
+
+            auto* addr   = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            auto  failed = errno;
+            ::close(fd);
+
+            if(addr == MAP_FAILED)
+            {
+                ::shm_unlink(name.c_str());
+                return xxas::error(Err::Mapping, "cannot map shared memory object (errno {})", failed);
+            };
+
+            auto* header = std::construct_at(static_cast<mem::shm::Header*>(addr), desc.base_addr, desc.page_size, capacity);
+            header->magic.store(mem::shm::magic, std::memory_order_release);
+
+            auto region = Region(header, [size, name](mem::shm::Header* ptr)
+            {
+                ::munmap(ptr, size);
+                ::shm_unlink(name.c_str());
+            });
+
+            return std::make_shared<Memory>(std::move(region), mem::Flags::Rw);
+        };
+
+        // Attaches to an address space created by `create_shared`, possibly in another host process.
+        // With `Read` alone the region is mapped read-only; such monitors read without the shared page locks.
+        static auto attach_shared(const std::string& name, const mem::Flags access = mem::Flags::Rw)
+            -> Result<std::shared_ptr<Memory>>
+        {
+            auto writable = mem::permits(access, mem::Flags::Write);
+
+            auto fd = ::shm_open(name.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC, 0);
+            if(fd < 0)
+            {
+                return xxas::error(Err::Mapping, "cannot open shared memory object (errno {})", errno);
+            };
+
+            struct stat status{};
+            if(::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(mem::shm::Header))
+            {
+                ::close(fd);
+                return xxas::error(Err::Mapping, "shared memory object is too small to hold an address space");
+            };
+
+            auto  size   = static_cast<std::size_t>(status.st_size);
+            auto* addr   = ::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+            auto  failed = errno;
+            ::close(fd);
+
+            if(addr == MAP_FAILED)
+            {
+                return xxas::error(Err::Mapping, "cannot map shared memory object (errno {})", failed);
+            };
+
+            auto region = Region(static_cast<mem::shm::Header*>(addr), [size](mem::shm::Header* ptr)
+            {
+                ::munmap(ptr, size);
+            });
+
+            if(region->magic.load(std::memory_order_acquire) != mem::shm::magic)
+            {
+                return xxas::error(Err::Mapping, "shared memory object does not hold an address space");
+            };
+
+            if(size < mem::shm::data_offset(region->page_size) + region->capacity)
+            {
+                return xxas::error(Err::Mapping, "shared memory object is smaller than its address space");
+            };
+
+            return std::make_shared<Memory>(std::move(region), writable ? mem::Flags::Rw : mem::Flags::Read);
+        };
+
+        // Returns if the page is backed by the shared region.
+        auto shares(const mem::Page& page) const noexcept
+            -> bool
+        {
+            return this->region && !page.mapping.owner_before(this->region) && !this->region.owner_before(page.mapping);
+        };
+
+        // Mirrors pages allocated in the shared region, including those of other processes, into `pages`.
+        auto sync()
+            -> void
+        {
+            if(!this->region)
+            {
+                return;
+            };
+
+            auto& header = *this->region;
+            auto* data   = reinterpret_cast<std::byte*>(this->region.get()) + mem::shm::data_offset(this->page_size);
+            auto  shared = mem::permits(this->region_access, mem::Flags::Write);
+
+            std::scoped_lock lock(this->mutex);
+
+            auto epoch = header.epoch.load(std::memory_order_acquire);
+            if(epoch == this->synced)
+            {
+                return;
+            };
+
+            // Held shared, so no entry is released while it's taken; a read-only mapping can't lock, nor hold entries.
+            std::shared_lock<mem::RwLock> entries_lock{};
+            if(shared)
+            {
+                entries_lock = std::shared_lock(header.lock);
+            };
+
+            this->held.resize(header.count.load(std::memory_order_acquire));
+
+            for(auto&& [entry, hold]: std::views::zip(header.entries, this->held))
+            {   // Freed pages are only kept by the attachments already holding them.
+                if(!entry.live.load(std::memory_order_acquire))
+                {
+                    continue;
+                };
+
+                auto generation = entry.generation.load(std::memory_order_acquire);
+                if(hold.generation == generation)
+                {
+                    continue;
+                };
+
+                // Held entries aren't reused, so only read-only mappings see a page replaced.
+                if(hold.generation != 0uz)
+                {
+                    std::erase_if(this->pages, [&](const auto& page)
+                    {
+                        return page.vaddr == hold.vaddr && this->shares(page);
+                    });
+                };
+
+                auto page = mem::Page
+                {
+                    entry.vaddr,
+                    entry.size,
+                    static_cast<mem::Flags>(std::to_underlying(entry.flags) & std::to_underlying(this->region_access)),
+                    mem::Page::Mapping(this->region, data + (entry.vaddr - this->base_addr)),
+                };
+
+                // A read-only mapping can't take the shared locks, so keeps the pages own.
+                if(shared)
+                {
+                    page.mutex = mem::Page::Mutex(this->region, &entry.lock);
+                    page.dirty = mem::Page::Dirty(this->region, &entry.dirty);
+
+                    entry.holders.fetch_add(1uz, std::memory_order_acq_rel);
+                };
+
+                hold = Held{generation, entry.vaddr};
+                this->pages.push_back(std::move(page));
+            };
+
+            this->synced = epoch;
+        };
+
         // Aligned allocation of a page with flags
         constexpr auto allocate(const std::size_t size, const mem::Flags flags = mem::Flags::Default, const std::size_t alignment = alignof(std::max_align_t))
             -> Result<std::uintptr_t>
         {
+            if(this->region)
+            {
+                return this->allocate_shared(size, flags, alignment);
+            };
+
             std::uintptr_t addr    = this->next_addr.fetch_add(size + alignment - 1);
             std::uintptr_t aligned = (addr + alignment - 1) & ~(alignment - 1);
             std::size_t offset     = aligned - this->base_addr;
 
-            if (this->bytes.size() < offset + size)
-            {   // Lock the resizing mutex.
-                std::scoped_lock lock(this->mutex);
+            // Lock the resizing mutex.
+            std::scoped_lock lock(this->mutex);
 
-                // Resize to make space for the allocation.
+            if (this->bytes.size() < offset + size)
+            {   // Resize to make space for the allocation.
                 this->bytes.resize(offset + size);
             };
 
@@ -235,6 +783,112 @@ namespace mint
             return aligned;
         };
 
+        // Allocates from the shared region, publishing the page to every attached process.
+        auto allocate_shared(const std::size_t size, const mem::Flags flags, const std::size_t alignment)
+            -> Result<std::uintptr_t>
+        {
+            if(!mem::permits(this->region_access, mem::Flags::Write))
+            {
+                return xxas::error(Err::NoPermission, "cannot allocate through a read-only shared address space");
+            };
+
+            auto&          header  = *this->region;
+            std::uintptr_t aligned = 0;
+            {
+                std::scoped_lock lock(header.lock);
+
+                auto align = [alignment](const std::uintptr_t vaddr)
+                {
+                    return (vaddr + alignment - 1) & ~(alignment - 1);
+                };
+
+                // Entries released by every attachment are reused before the address space grows.
+                auto count    = header.count.load(std::memory_order_relaxed);
+                auto released = std::ranges::find_if(header.entries | std::views::take(count), [&](const auto& entry)
+                {
+                    return !entry.live.load(std::memory_order_relaxed) && entry.holders.load(std::memory_order_acquire) == 0uz
+                        && align(entry.base) + size <= entry.base + entry.extent;
+                });
+
+                auto index = static_cast<std::size_t>(std::ranges::distance(header.entries.begin(), released));
+                if(index == mem::shm::max_pages)
+                {
+                    return xxas::error(Err::OutOfRange, "shared address space is limited to {} pages", mem::shm::max_pages);
+                };
+
+                auto& entry = header.entries[index];
+                if(index < count)
+                {   // Reused bytes read as zeroes, as fresh ones do.
+                    aligned = align(entry.base);
+
+                    auto* data = reinterpret_cast<std::byte*>(this->region.get()) + mem::shm::data_offset(this->page_size);
+                    std::memset(data + (aligned - this->base_addr), 0, size);
+                }
+                else
+                {
+                    auto next = header.next_addr.load(std::memory_order_relaxed);
+
+                    aligned = align(next);
+                    if(aligned + size > header.base_addr + header.capacity)
+                    {
+                        return xxas::error(Err::OutOfRange, "shared address space of {:#x} bytes is exhausted", header.capacity);
+                    };
+
+                    entry.base   = next;
+                    entry.extent = aligned + size - next;
+
+                    header.next_addr.store(aligned + size, std::memory_order_relaxed);
+                };
+
+                entry.vaddr = aligned;
+                entry.size  = size;
+                entry.flags = flags;
+                entry.dirty.store(false, std::memory_order_relaxed);
+                entry.generation.fetch_add(1uz, std::memory_order_relaxed);
+                entry.live.store(true, std::memory_order_release);
+
+                if(index == count)
+                {
+                    header.count.store(count + 1uz, std::memory_order_release);
+                };
+
+                header.epoch.fetch_add(1uz, std::memory_order_release);
+            };
+
+            this->sync();
+            return aligned;
+        };
+
+        // Frees the shared page at `vaddr`, dropping this processes hold on its entry; called with `mutex` held.
+        auto release(const std::uintptr_t vaddr)
+            -> void
+        {
+            if(!mem::permits(this->region_access, mem::Flags::Write))
+            {
+                return;
+            };
+
+            auto hold = std::ranges::find_if(this->held, [vaddr](const auto& hold)
+            {
+                return hold.generation != 0uz && hold.vaddr == vaddr;
+            });
+
+            if(hold == this->held.end())
+            {
+                return;
+            };
+
+            auto& entry = this->region->entries[static_cast<std::size_t>(std::ranges::distance(this->held.begin(), hold))];
+            {   // Serialized with syncs taking the entry, so none holds it once it's released.
+                std::scoped_lock lock(this->region->lock);
+
+                entry.live.store(false, std::memory_order_release);
+                entry.holders.fetch_sub(1uz, std::memory_order_acq_rel);
+            };
+
+            *hold = Held{};
+        };
+
         // Deallocate memory by virtual address
         constexpr void free(const std::uintptr_t vaddr)
         {
@@ -250,6 +904,22 @@ namespace mint
                 return;
             };
 
+            // File mappings live apart from allocations; the host mapping is released with its last page reference.
+            // Shared pages are freed for every process, but only released once no other one still holds them.
+            if(page_it->mapping)
+            {
+                if(this->shares(*page_it))
+                {
+                    this->release(page_it->vaddr);
+                };
+
+                this->pages.erase(page_it);
+                return;
+            };
+
+            // The bytes may be reused or released; a checkpoint keeping the page restores them on reset.
+            page_it->dirty->store(true, std::memory_order_relaxed);
+
             auto vm_span = VMSpan(page_it->vaddr, page_it->size);
             this->pages.erase(page_it);
 
@@ -295,39 +965,272 @@ namespace mint
             };
         };
 
-        // Get a thread-safe shared memory slice.
-        template<class T = std::byte> constexpr auto slice(const std::uintptr_t vaddr, const std::size_t vsize)
-            -> Result<mem::Shared<T>>
+        // Records the address space as `reset` restores it, e.g. once an instance is set up.
+        // Pages written before the checkpoint keep their contents across resets.
+        auto checkpoint()
+            -> void
         {
-            for(auto& page: this->pages)
+            std::scoped_lock lock(this->mutex);
+
+            auto snapshot = Snapshot
             {
-                if (page.contains(vaddr))
+                .next_addr     = this->next_addr.load(),
+                .next_map_addr = this->next_map_addr.load(),
+                .pages         = this->pages,
+                .freed         = this->freed,
+                .bytes         = this->bytes,
+            };
+
+            snapshot.mapped.resize(this->pages.size());
+            for(auto n = 0uz; n < this->pages.size(); ++n)
+            {
+                auto& page    = this->pages[n];
+                auto  written = page.dirty->exchange(false, std::memory_order_relaxed);
+
+                // Shared pages are zeroed by other processes, so are always kept; file pages only once written.
+                if(page.mapping && mem::permits(page.flags, mem::Flags::Write) && (written || this->shares(page)))
+                {
+                    snapshot.mapped[n].assign(page.mapping.get(), page.mapping.get() + page.size);
+                };
+            };
+
+            this->snapshot = std::move(snapshot);
+        };
+
+        // Restores pages written since the last reset to their contents at the checkpoint, and drops allocations and
+        // mappings made since; without a checkpoint, written pages are zeroed and every allocation is kept.
+        // Written copy-on-write file pages revert to the file contents, and shared pages are restored for every attached process.
+        // Shared allocations are published to other processes, so are never dropped.
+        auto reset()
+            -> void
+        {
+            std::scoped_lock lock(this->mutex);
+
+            if(this->snapshot && !this->region)
+            {   // Drop what was allocated, mapped and freed since; pages freed since were marked written.
+                this->next_addr.store(this->snapshot->next_addr);
+                this->next_map_addr.store(this->snapshot->next_map_addr);
+                this->pages = this->snapshot->pages;
+                this->freed = this->snapshot->freed;
+                this->bytes.resize(this->snapshot->bytes.size());
+            };
+
+            for(auto n = 0uz; n < this->pages.size(); ++n)
+            {
+                auto& page = this->pages[n];
+                if(!page.dirty->exchange(false, std::memory_order_relaxed))
                 {
-                    std::size_t offset = vaddr - page.vaddr;
-                    return mem::Shared<T>
+                    continue;
+                };
+
+                // Contents at the checkpoint, if the page is mapped and was kept by it.
+                const auto* kept = this->snapshot && n < this->snapshot->mapped.size() && !this->snapshot->mapped[n].empty()
+                    ? &this->snapshot->mapped[n]
+                    : nullptr;
+
+                if(page.mapping && kept)
+                {
+                    std::ranges::copy(*kept, page.mapping.get());
+                    continue;
+                };
+
+                if(this->shares(page))
+                {   // Read-only attachments can't write the region, nor have dirtied it.
+                    if(mem::permits(this->region_access, mem::Flags::Write))
                     {
-                        .span = std::span<T>
+                        std::memset(page.mapping.get(), 0, page.size);
+                    };
+
+                    continue;
+                };
+
+                if(page.mapping)
+                {
+                    ::madvise(page.mapping.get(), page.size, MADV_DONTNEED);
+                    continue;
+                };
+
+                auto offset = page.vaddr - this->base_addr;
+                if(offset >= this->bytes.size())
+                {
+                    continue;
+                };
+
+                auto size = std::min(page.size, this->bytes.size() - offset);
+                auto copy = 0uz;
+
+                if(this->snapshot && offset < this->snapshot->bytes.size())
+                {
+                    copy = std::min(size, this->snapshot->bytes.size() - offset);
+                    std::memcpy(this->bytes.data() + offset, this->snapshot->bytes.data() + offset, copy);
+                };
+
+                std::memset(this->bytes.data() + offset + copy, 0, size - copy);
+            };
+        };
+
+        // Maps a host file into a guest virtual range without copying it.
+        // Without `Write` the pages are read-only; with it they're private copy-on-write, and never written back to the file.
+        auto map_file(const std::filesystem::path& path, const mem::Flags flags = mem::Flags::Read)
+            -> Result<std::uintptr_t>
+        {
+            auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if(fd < 0)
+            {
+                return xxas::error(Err::Mapping, "cannot open {} for mapping", xxas::err::intern(path.string()));
+            };
+
+            struct stat status{};
+            if(::fstat(fd, &status) != 0 || status.st_size <= 0)
+            {
+                ::close(fd);
+                return xxas::error(Err::Mapping, "cannot map empty or unreadable file {}", xxas::err::intern(path.string()));
+            };
+
+            auto size = static_cast<std::size_t>(status.st_size);
+            auto prot = (mem::permits(flags, mem::Flags::Read)  ? PROT_READ  : PROT_NONE)
+                      | (mem::permits(flags, mem::Flags::Write) ? PROT_WRITE : PROT_NONE);
+
+            // The descriptor isn't needed once mapped.
+            auto* addr = ::mmap(nullptr, size, prot, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if(addr == MAP_FAILED)
+            {
+                return xxas::error(Err::Mapping, "cannot map file {}", xxas::err::intern(path.string()));
+            };
+
+            auto mapping = mem::Page::Mapping(static_cast<std::byte*>(addr), [size](std::byte* ptr)
+            {
+                ::munmap(ptr, size);
+            });
+
+            // Reserve a page aligned guest range for the mapping.
+            auto vsize = (size + this->page_size - 1) / this->page_size * this->page_size;
+            auto vaddr = this->next_map_addr.fetch_add(vsize);
+
+            std::scoped_lock lock(this->mutex);
+            this->pages.push_back(mem::Page
+            {
+                vaddr,
+                size,
+                flags,
+                std::move(mapping),
+            });
+
+            return vaddr;
+        };
+
+        // Maps host bytes of static storage duration, such as a precomputed data segment, into a read-only
+        // guest range without copying them; the bytes must outlive the address space.
+        auto map_static(const std::span<const std::byte> bytes)
+            -> Result<std::uintptr_t>
+        {
+            if(bytes.empty())
+            {
+                return xxas::error(Err::Mapping, "cannot map an empty range");
+            };
+
+            // Never written through, as the page grants no `Write` and `Dispatch` hands handlers copies of
+            // read-only words, faulting on stores to them; nothing to release.
+            auto mapping = mem::Page::Mapping(const_cast<std::byte*>(bytes.data()), [](std::byte*) {});
+
+            auto vsize = (bytes.size() + this->page_size - 1) / this->page_size * this->page_size;
+            auto vaddr = this->next_map_addr.fetch_add(vsize);
+
+            std::scoped_lock lock(this->mutex);
+            this->pages.push_back(mem::Page
+            {
+                vaddr,
+                bytes.size(),
+                mem::Flags::Read,
+                std::move(mapping),
+            });
+
+            return vaddr;
+        };
+
+        // Get a thread-safe shared memory slice; `access` are the permissions the page must grant, and slices
+        // written through must be requested with `mem::Flags::Write`.
+        template<class T = std::byte> constexpr auto slice(const std::uintptr_t vaddr, const std::size_t vsize, const mem::Flags access = mem::Flags::Read)
+            -> Result<mem::Shared<T>>
+        {
+            auto stale = false;
+            {   // Held shared, as `sync` may append pages from another thread.
+                std::shared_lock lock(this->mutex);
+
+                for(auto& page: this->pages)
+                {
+                    if (page.contains(vaddr))
+                    {
+                        std::size_t offset = vaddr - page.vaddr;
+
+                        if(offset + vsize > page.size)
+                        {
+                            break;
+                        };
+
+                        if(!mem::permits(page.flags, access))
+                        {
+                            return xxas::error(Err::NoPermission, "vaddr of {:#x} lacks the requested permissions", vaddr);
+                        };
+
+                        auto shared = mem::Shared<T>
+                        {
+                            .span = std::span<T>
+                            {
+                                reinterpret_cast<T*>((page.mapping ? page.mapping.get() : bytes.data() + (page.vaddr - this->base_addr)) + offset),
+                                vsize / sizeof(T)
+                            },
+                            .mutex = page.mutex,
+                            .dirty = page.dirty,
+                        };
+
+                        // Slices handed out for writing may be written through directly.
+                        if(mem::permits(access, mem::Flags::Write))
                         {
-                            reinterpret_cast<T*>(bytes.data() + (page.vaddr - this->base_addr) + offset),
-                            vsize / sizeof(T)
-                        },
-                        .mutex = page.mutex
+                            shared.mark();
+                        };
+
+                        return shared;
                     };
                 };
+
+                // The page may have since been allocated by another process.
+                stale = this->region && this->synced != this->region->epoch.load(std::memory_order_acquire);
+            };
+
+            if(stale)
+            {
+                this->sync();
+                return this->slice<T>(vaddr, vsize, access);
             };
 
-            return xxas::error(Err::OutOfRange, std::format("vaddr of {:#x} is out of range", vaddr));
+            return xxas::error(Err::OutOfRange, "vaddr of {:#x} is out of range", vaddr);
         };
 
       protected:
         constexpr auto peek(std::uintptr_t vaddr)
             -> Result<std::uintptr_t>
         {
+            std::shared_lock lock(this->mutex);
+
             for(auto& page: this->pages)
             {
                 if (page.contains(vaddr))
                 {
                     std::size_t offset   = vaddr - page.vaddr;
+
+                    if(page.mapping)
+                    {
+                        if(offset + sizeof(std::uintptr_t) <= page.size)
+                        {
+                            return *reinterpret_cast<std::uintptr_t*>(page.mapping.get() + offset);
+                        };
+
+                        break;
+                    };
+
                     std::size_t absolute = (page.vaddr - this->base_addr) + offset;
 
                     if(absolute < this->bytes.size())
@@ -337,7 +1240,7 @@ namespace mint
                 };
             };
 
-            return xxas::error(Err::OutOfRange, std::format("vaddr of {:#x} is out of range", vaddr));
+            return xxas::error(Err::OutOfRange, "vaddr of {:#x} is out of range", vaddr);
         }
     };
 };
@@ -4,9 +4,11 @@ export import :memory;
 export import :stackframe;
 export import :cpu;
 
+export import :io;
 export import :context;
 
 export import :scalar;
+export import :wide;
 
 export import :traits;
 export import :semantics;
@@ -18,5 +20,10 @@ export import :operand;
 export import :instruction;
 
 export import :binding;
+export import :dispatch;
+export import :tiered;
+export import :passes;
+export import :comptime;
 export import :jit_compiler;
 export import :instance;
+export import :profiler;
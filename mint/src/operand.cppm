@@ -33,22 +33,38 @@ namespace mint
 
         using Result   = xxas::Result<Scalar, Err, Memory::Err>;
 
+        // Returns the page permissions a memory operand requires; destinations are written.
+        constexpr static auto access(const Traits traits) noexcept
+            -> mem::Flags
+        {
+            return traits.get_as<traits::Direction>() == traits::Direction::Dest ? mem::Flags::Rw : mem::Flags::Read;
+        };
+
         template<const auto& arch> constexpr static inline std::array source_map
         {   // Register from scalar.
             +[](Traits& _, const Expression& expression, ThreadContext<arch>& ctx)
                 -> Result
-            {   // Get the register id from the scalar.
+            {   // Get the register id from the scalar; the keyword index of the register.
                 auto regid = expression.evaluate<std::size_t>();
 
-                // Get the thread register file through thread environment.
-                auto thread_data = ctx.get_data();
+                if(regid >= arch.keywords.entries.size())
+                {
+                    return xxas::error(Err::Uninitialized, "Register id {} is not a keyword", regid);
+                };
+
+                // Get the thread register file through thread environment; keywords that aren't registers have no storage.
+                auto& registers = ctx.get_data().registers;
+                auto  it        = registers.find(arch.keywords.entries[regid].first);
 
-                auto& reg = thread_data.registers[regid];
+                if(it == registers.end())
+                {
+                    return xxas::error(Err::Uninitialized, "Keyword {} is not a register", regid);
+                };
 
                 // Extract the underlying bytes of the register from regid.
                 return Scalar
                 {{
-                    reg.data(), reg.size()
+                    it->second.data(), it->second.size()
                 }};
             },
             // Immediate value from scalar.
@@ -69,7 +85,7 @@ namespace mint
                 auto vaddr  = expression.evaluate<std::uintptr_t>();
                 auto mem = ctx.process->mem;
 
-                auto slice_result = mem->slice(vaddr, traits.size());
+                auto slice_result = mem->slice(vaddr, traits.size(), Operand::access(traits));
                 if(!slice_result)
                 {
                     return slice_result.error();
@@ -88,8 +104,16 @@ namespace mint
 
         template<const auto& arch> auto evaluate(ThreadContext<arch>& env)
             -> Result
-        {   // Get the source function for the traits of the operand.
-            const auto& source_funct = source_map<arch>[static_cast<std::size_t>(this->traits.get<traits::Source>())];
+        {
+            auto source = traits::index(this->traits.get_as<traits::Source>());
+
+            if(source >= source_map<arch>.size())
+            {
+                return xxas::error(Err::Uninitialized, "Operand has no single source");
+            };
+
+            // Get the source function for the traits of the operand.
+            const auto& source_funct = source_map<arch>[source];
 
             // Return the evaluated result from the source function.
             return std::invoke(source_funct, this->traits, this->expression, env);
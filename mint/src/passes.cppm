@@ -0,0 +1,550 @@
+export module mint: passes;
+
+import std;
+import xxas;
+
+import :traits;
+import :scalar;
+import :expression;
+import :operand;
+import :instruction;
+import :arch;
+import :dispatch;
+
+/*** **
+ **
+ **  module:   mint: passes
+ **  purpose:  Optimization pass pipeline over instruction IR; passes only transform
+ **            instructions whose opcodes the architecture declares legal for them.
+ **
+ *** **/
+
+namespace mint
+{
+    namespace pass
+    {   // Changes made by a single pass.
+        export struct Report
+        {
+            std::string_view name;
+
+            // Instructions changed in place.
+            std::size_t      rewritten{};
+
+            // Instructions removed.
+            std::size_t      removed{};
+        };
+
+        // Returns the register id an operand names, if it's a register.
+        auto register_of(const Operand& operand)
+            -> std::optional<std::size_t>
+        {
+            if(operand.traits.get_as<traits::Source>() != traits::Source::Register)
+            {
+                return std::nullopt;
+            };
+
+            return operand.expression.evaluate<std::size_t>();
+        };
+
+        // Returns the widest bitness of the operands; the word a specialized handler operates on.
+        auto bitness(const Instruction& insn)
+            -> std::uint8_t
+        {
+            std::uint8_t bitness = 0u;
+            for(const auto& operand: insn.operands)
+            {
+                bitness = std::max<std::uint8_t>(bitness, operand.traits.get<traits::Bitness>());
+            };
+
+            return bitness;
+        };
+
+        // Returns the value of an immediate operand, zero extended as a handler widens it.
+        auto immediate_of(const Operand& operand)
+            -> std::optional<std::uint64_t>
+        {
+            if(operand.traits.get_as<traits::Source>() != traits::Source::Immediate)
+            {
+                return std::nullopt;
+            };
+
+            auto leaf = operand.expression.constant();
+            if(!leaf)
+            {
+                return std::nullopt;
+            };
+
+            // Wider immediates are left to the handlers.
+            if(std::ranges::any_of(leaf->bytes | std::views::drop(sizeof(std::uint64_t)), [](const std::byte byte) { return byte != std::byte{0}; }))
+            {
+                return std::nullopt;
+            };
+
+            std::uint64_t value = 0u;
+            std::memcpy(&value, leaf->bytes.data(), std::min(sizeof(value), leaf->bytes.size()));
+
+            return value;
+        };
+
+        // Creates an immediate operand of `bitness` holding `value`; its bytes are allocated from the arena `resource`,
+        // and released with it, as operands don't own their leaves.
+        auto immediate(const Traits like, const std::uint8_t bitness, const std::uint64_t value, Program::Resource* resource)
+            -> Operand
+        {
+            auto* bytes = static_cast<std::byte*>(resource->allocate(sizeof(value), alignof(std::uint64_t)));
+            std::memcpy(bytes, &value, sizeof(value));
+
+            auto traits = like;
+            traits.bits = static_cast<std::uint8_t>((traits.bits & ~(std::to_underlying(traits::Source::Mask) | std::to_underlying(traits::Bitness::Mask)))
+                | std::to_underlying(traits::Source::Immediate) | bitness);
+
+            return Operand{Expression{Scalar{{bytes, sizeof(value)}}, resource}, traits};
+        };
+
+        // Removes the instructions marked dead, keeping the order of the rest.
+        auto compact(Insns& insns, const std::vector<bool>& dead)
+            -> std::size_t
+        {
+            auto kept = 0uz;
+            for(auto n = 0uz; n < insns.size(); ++n)
+            {
+                if(dead[n])
+                {
+                    continue;
+                };
+
+                if(kept != n)
+                {
+                    insns[kept] = std::move(insns[n]);
+                };
+
+                kept = kept + 1uz;
+            };
+
+            auto removed = insns.size() - kept;
+            insns.erase(insns.begin() + static_cast<std::ptrdiff_t>(kept), insns.end());
+
+            return removed;
+        };
+    };
+
+    export template<const auto& arch> struct Optimizer
+    {
+        // Constants are allocated from a program arena; nothing else would release them.
+        using Resource = Program::Resource;
+        using Pass     = auto(*)(Insns&, Resource*) -> pass::Report;
+        using Passes   = std::vector<Pass>;
+        using Reports  = std::vector<pass::Report>;
+
+        // Register ids -> values they are known to hold.
+        using Known    = std::unordered_map<std::size_t, std::uint64_t>;
+
+        // Passes run in order by `run`.
+        Passes passes
+        {
+            &Optimizer::propagate, &Optimizer::redundant_moves, &Optimizer::dead_stores, &Optimizer::fuse,
+        };
+
+        // Returns the first opcode declared as a move.
+        static auto move_opcode()
+            -> std::optional<std::size_t>
+        {
+            for(auto opcode = 0uz; opcode < arch.legality.size(); ++opcode)
+            {
+                if(arch::allows(arch.legal(opcode), arch::Legal::Move))
+                {
+                    return opcode;
+                };
+            };
+
+            return std::nullopt;
+        };
+
+        // Returns if the instruction fully writes its first operand without other effects.
+        static auto pure(const Instruction& insn)
+            -> bool
+        {
+            return arch::allows(arch.legal(insn.opcode), arch::Legal::Pure) && !insn.operands.empty();
+        };
+
+        // Returns if the instruction's handler returns errors at any width; a fault it raises can't be folded or removed.
+        static auto fallible(const Instruction& insn)
+            -> bool
+        {
+            if(insn.opcode >= arch.insns.entries.size())
+            {
+                return true;
+            };
+
+            return std::visit([]<class F>(const F&)
+            {
+                return []<auto... Width>(std::index_sequence<Width...>)
+                {
+                    return (Optimizer::fails<F, dispatch::Word<dispatch::bitnesses[Width]>>() || ...);
+                }(std::make_index_sequence<dispatch::widths<arch>>{});
+            }, arch.insns.entries[insn.opcode].second);
+        };
+
+        // Returns if `F` invoked on words `Word` returns a dispatch result.
+        template<class F, class Word> constexpr static auto fails()
+            -> bool
+        {
+            constexpr auto arity = dispatch::arity<F, Word>();
+
+            if constexpr(arity == dispatch::npos || arity == 0uz)
+            {
+                return false;
+            }
+            else
+            {
+                return []<auto... In>(std::index_sequence<In...>)
+                {
+                    return std::convertible_to<std::invoke_result_t<const F&, dispatch::Repeat<In, Word&>...>, typename Dispatch<arch>::Result>;
+                }(std::make_index_sequence<arity>{});
+            };
+        };
+
+        // Returns if the instruction writes the whole of register `reg`, rather than only its low bytes; ids past
+        // the keywords aren't registers, so are never covered.
+        static auto covers(const Instruction& insn, const std::size_t reg)
+            -> bool
+        {
+            if(reg >= arch.keywords.entries.size())
+            {
+                return false;
+            };
+
+            auto bitness = pass::bitness(insn);
+            return bitness != 0u && (1uz << traits::index(static_cast<traits::Bitness>(bitness))) >= arch.keywords.entries[reg].second.size();
+        };
+
+        // Evaluates a pure instruction whose sources are all immediates, as its specialized handler would.
+        static auto fold(const Instruction& insn)
+            -> std::optional<std::uint64_t>
+        {
+            auto width = traits::index(static_cast<traits::Bitness>(pass::bitness(insn)));
+
+            return [&]<auto... Width>(std::index_sequence<Width...>)
+            {
+                std::optional<std::uint64_t> result{};
+
+                static_cast<void>(((Width == width && (result = Optimizer::evaluate<dispatch::bitnesses[Width]>(insn), true)) || ...));
+                return result;
+            }(std::make_index_sequence<dispatch::widths<arch>>{});
+        };
+
+        // Invokes the instruction on words of bitness `B`, returning its first operand.
+        template<traits::Bitness B> static auto evaluate(const Instruction& insn)
+            -> std::optional<std::uint64_t>
+        {
+            using Word = dispatch::Word<B>;
+
+            return std::visit([&insn]<class F>(const F& funct)
+                -> std::optional<std::uint64_t>
+            {
+                constexpr auto arity = dispatch::arity<F, Word>();
+
+                if constexpr(arity == dispatch::npos || arity == 0uz)
+                {
+                    return std::nullopt;
+                }
+                else
+                {
+                    if(insn.operands.size() != arity)
+                    {
+                        return std::nullopt;
+                    };
+
+                    // The destination starts zeroed; a pure instruction doesn't read it.
+                    std::array<Word, arity> words{};
+                    for(auto n = 1uz; n < arity; ++n)
+                    {
+                        auto value = pass::immediate_of(insn.operands[n]);
+                        if(!value)
+                        {
+                            return std::nullopt;
+                        };
+
+                        words[n] = static_cast<Word>(*value);
+                    };
+
+                    auto invoked = [&]<auto... In>(std::index_sequence<In...>)
+                        -> bool
+                    {
+                        using Invoked = std::invoke_result_t<const F&, dispatch::Repeat<In, Word&>...>;
+
+                        if constexpr(std::convertible_to<Invoked, typename Dispatch<arch>::Result>)
+                        {   // Failing instructions are left to fail when executed.
+                            return static_cast<typename Dispatch<arch>::Result>(std::invoke(funct, words[In]...)).has_value();
+                        }
+                        else
+                        {
+                            static_cast<void>(std::invoke(funct, words[In]...));
+                            return true;
+                        };
+                    }(std::make_index_sequence<arity>{});
+
+                    if(!invoked)
+                    {
+                        return std::nullopt;
+                    };
+
+                    // Results wider than an immediate aren't folded.
+                    if(static_cast<Word>(static_cast<std::uint64_t>(words[0])) != words[0])
+                    {
+                        return std::nullopt;
+                    };
+
+                    return static_cast<std::uint64_t>(words[0]);
+                };
+            }, arch.insns.entries[insn.opcode].second);
+        };
+
+        // Records the registers the instruction writes; instructions not declared pure may write any register, so forget every value.
+        static auto observe(Known& known, const Instruction& insn)
+            -> void
+        {
+            if(!Optimizer::pure(insn))
+            {
+                known.clear();
+                return;
+            };
+
+            auto dest = pass::register_of(insn.operands.front());
+            if(!dest)
+            {
+                return;
+            };
+
+            // Moves of immediates are known; so are folded instructions, rewritten as such moves.
+            auto value = arch::allows(arch.legal(insn.opcode), arch::Legal::Move) && insn.operands.size() == 2uz
+                ? pass::immediate_of(insn.operands[1])
+                : std::nullopt;
+
+            if(value && Optimizer::covers(insn, *dest))
+            {
+                known.insert_or_assign(*dest, *value);
+                return;
+            };
+
+            known.erase(*dest);
+        };
+
+        // Replaces register sources holding known values with immediates, and folds pure instructions of immediates into moves.
+        static auto propagate(Insns& insns, Resource* resource)
+            -> pass::Report
+        {
+            pass::Report report{.name = "propagate"};
+
+            Known known{};
+            auto  move = Optimizer::move_opcode();
+
+            for(auto& insn: insns)
+            {
+                if(Optimizer::pure(insn))
+                {
+                    auto changed = false;
+
+                    for(auto& operand: insn.operands | std::views::drop(1uz))
+                    {
+                        auto reg = pass::register_of(operand);
+                        if(!reg)
+                        {
+                            continue;
+                        };
+
+                        if(auto it = known.find(*reg); it != known.end())
+                        {
+                            operand = pass::immediate(operand.traits, operand.traits.get<traits::Bitness>(), it->second, resource);
+                            changed = true;
+                        };
+                    };
+
+                    // Fold into a move of the result, keeping the handler word.
+                    if(move && insn.opcode != *move)
+                    {
+                        if(auto value = Optimizer::fold(insn))
+                        {
+                            auto bitness  = pass::bitness(insn);
+                            auto operands = Instruction::Operands{insn.operands.get_allocator()};
+
+                            operands.push_back(std::move(insn.operands.front()));
+                            operands.push_back(pass::immediate(operands.front().traits, bitness, *value, resource));
+
+                            insn.opcode   = *move;
+                            insn.operands = std::move(operands);
+                            changed       = true;
+                        };
+                    };
+
+                    report.rewritten = report.rewritten + (changed ? 1uz : 0uz);
+                };
+
+                Optimizer::observe(known, insn);
+            };
+
+            return report;
+        };
+
+        // Removes moves of a register into itself, and moves of a value the destination is known to hold.
+        static auto redundant_moves(Insns& insns, Resource*)
+            -> pass::Report
+        {
+            pass::Report report{.name = "redundant_moves"};
+
+            Known known{};
+            std::vector<bool> dead(insns.size(), false);
+
+            for(auto n = 0uz; n < insns.size(); ++n)
+            {
+                const auto& insn = insns[n];
+
+                if(arch::allows(arch.legal(insn.opcode), arch::Legal::Move) && insn.operands.size() == 2uz)
+                {
+                    auto dest  = pass::register_of(insn.operands[0]);
+                    auto src   = pass::register_of(insn.operands[1]);
+                    auto value = pass::immediate_of(insn.operands[1]);
+
+                    auto self  = dest && src && *dest == *src && Optimizer::covers(insn, *dest);
+                    auto known_value = dest && value && known.contains(*dest) && known.at(*dest) == *value && Optimizer::covers(insn, *dest);
+
+                    if(self || known_value)
+                    {
+                        dead[n] = true;
+                        continue;
+                    };
+                };
+
+                Optimizer::observe(known, insn);
+            };
+
+            report.removed = pass::compact(insns, dead);
+            return report;
+        };
+
+        // Removes pure instructions whose register result is overwritten before it's read.
+        static auto dead_stores(Insns& insns, Resource*)
+            -> pass::Report
+        {
+            pass::Report report{.name = "dead_stores"};
+
+            // Registers fully overwritten later, without being read in between; every register is live at the end.
+            std::unordered_set<std::size_t> overwritten{};
+            std::vector<bool> dead(insns.size(), false);
+
+            for(auto n = insns.size(); n-- > 0uz;)
+            {
+                const auto& insn = insns[n];
+                if(!Optimizer::pure(insn) || Optimizer::fallible(insn))
+                {   // Instructions not declared pure may read any register; those that fail stop before later writes.
+                    overwritten.clear();
+                    continue;
+                };
+
+                auto dest = pass::register_of(insn.operands.front());
+
+                if(!dest)
+                {   // Any register referenced may be read.
+                    for(const auto& operand: insn.operands)
+                    {
+                        if(auto reg = pass::register_of(operand))
+                        {
+                            overwritten.erase(*reg);
+                        };
+                    };
+
+                    continue;
+                };
+
+                if(overwritten.contains(*dest))
+                {
+                    dead[n] = true;
+                    continue;
+                };
+
+                if(Optimizer::covers(insn, *dest))
+                {
+                    overwritten.insert(*dest);
+                };
+
+                for(const auto& operand: insn.operands | std::views::drop(1uz))
+                {
+                    if(auto reg = pass::register_of(operand))
+                    {
+                        overwritten.erase(*reg);
+                    };
+                };
+            };
+
+            report.removed = pass::compact(insns, dead);
+            return report;
+        };
+
+        // Fuses adjacent instruction pairs into the superinstructions the architecture declares for them.
+        static auto fuse(Insns& insns, Resource*)
+            -> pass::Report
+        {
+            pass::Report report{.name = "fuse"};
+
+            std::vector<bool> dead(insns.size(), false);
+
+            for(auto n = 0uz; n + 1uz < insns.size(); ++n)
+            {
+                auto& first  = insns[n];
+                auto& second = insns[n + 1uz];
+
+                auto fused = arch.fused(first.opcode, second.opcode);
+                if(!fused)
+                {
+                    continue;
+                };
+
+                // Take the operands of both; restore them if the superinstruction can't be specialized.
+                auto opcode = first.opcode;
+                auto split  = first.operands.size();
+
+                first.opcode = *fused;
+                std::ranges::move(second.operands, std::back_inserter(first.operands));
+
+                if(!Dispatch<arch>::find(first))
+                {
+                    std::ranges::move(first.operands | std::views::drop(split), second.operands.begin());
+                    first.operands.erase(first.operands.begin() + static_cast<std::ptrdiff_t>(split), first.operands.end());
+                    first.opcode = opcode;
+
+                    continue;
+                };
+
+                dead[n + 1uz]    = true;
+                report.rewritten = report.rewritten + 1uz;
+
+                n = n + 1uz;
+            };
+
+            report.removed = pass::compact(insns, dead);
+            return report;
+        };
+
+        // Runs every pass in order; constants introduced are allocated from the arena `resource`, which must outlive the instructions.
+        auto run(Insns& insns, Resource* resource) const
+            -> Reports
+        {
+            Reports reports{};
+            reports.reserve(this->passes.size());
+
+            for(const auto& funct: this->passes)
+            {
+                reports.push_back(std::invoke(funct, insns, resource));
+            };
+
+            return reports;
+        };
+
+        // Runs every pass over the program, allocating constants from its arena.
+        auto run(Program& program) const
+            -> Reports
+        {
+            return this->run(program.insns, program.arena());
+        };
+    };
+};
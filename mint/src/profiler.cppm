@@ -0,0 +1,258 @@
+export module mint: profiler;
+
+import std;
+import xxas;
+
+import :memory;
+import :stackframe;
+import :cpu;
+import :context;
+
+/*** **
+ **
+ **  module:   mint: profiler
+ **  purpose:  Sampling profiler for guest threads, unwinding guest call stacks
+ **            through the saved base pointer chain into collapsed stacks.
+ **
+ *** **/
+
+namespace mint
+{
+    namespace prof
+    {   // Maximum frames recorded per sample.
+        export constexpr inline std::size_t max_depth = 32uz;
+
+        // Samples buffered per thread before samples are dropped.
+        export constexpr inline std::size_t ring_size = 0x400;
+
+        // Default interval between sample requests.
+        export constexpr inline std::chrono::microseconds default_interval{1000};
+
+        // Guest call stack; `frames[0]` is the sampled ip, followed by each callers return ip.
+        export struct Sample
+        {
+            std::array<std::size_t, max_depth> frames{};
+            std::size_t                        depth{};
+        };
+
+        // Lock-free single producer, single consumer ring buffer.
+        export template<class T, std::size_t N> requires(std::has_single_bit(N)) struct Ring
+        {
+            using Array = std::array<T, N>;
+
+            Array elements{};
+
+            // Written by the producer, read by the consumer.
+            alignas(64) std::atomic_size_t head{};
+
+            // Written by the consumer, read by the producer.
+            alignas(64) std::atomic_size_t tail{};
+
+            // Pushes a value, returns false if the ring is full.
+            auto push(const T& value) noexcept
+                -> bool
+            {
+                auto head = this->head.load(std::memory_order_relaxed);
+
+                if(head - this->tail.load(std::memory_order_acquire) == N)
+                {
+                    return false;
+                };
+
+                this->elements[head & (N - 1uz)] = value;
+                this->head.store(head + 1uz, std::memory_order_release);
+
+                return true;
+            };
+
+            // Pops the oldest value, if any.
+            auto pop() noexcept
+                -> std::optional<T>
+            {
+                auto tail = this->tail.load(std::memory_order_relaxed);
+
+                if(tail == this->head.load(std::memory_order_acquire))
+                {
+                    return std::nullopt;
+                };
+
+                auto value = this->elements[tail & (N - 1uz)];
+                this->tail.store(tail + 1uz, std::memory_order_release);
+
+                return value;
+            };
+        };
+
+        // Per-thread sampling state, written by the guest thread itself.
+        export struct Sampler
+        {   // Set by the timer; consumed by the guest thread at its next poll.
+            std::atomic_bool pending{};
+
+            // Samples lost to a full ring.
+            std::atomic_size_t dropped{};
+
+            Ring<Sample, ring_size> ring{};
+        };
+
+        // Function start addresses -> function names.
+        export using Symbols = std::map<std::size_t, std::string>;
+    };
+
+    export struct Profiler
+    {
+        using SamplerPtr = std::unique_ptr<prof::Sampler>;
+        using SamplerVec = std::vector<SamplerPtr>;
+
+        // Time between sample requests.
+        std::chrono::microseconds interval{prof::default_interval};
+
+        // Registered samplers; stable addresses for the guest threads.
+        SamplerVec samplers{};
+
+        // Locks during sampler registration and iteration.
+        std::mutex mutex{};
+
+        // Raises sample requests while running.
+        std::jthread timer{};
+
+        explicit Profiler(const std::chrono::microseconds interval = prof::default_interval)
+            : interval{interval} {};
+
+        // Registers a sampler for a guest thread.
+        auto attach()
+            -> prof::Sampler&
+        {
+            std::scoped_lock lock(this->mutex);
+            return *this->samplers.emplace_back(std::make_unique<prof::Sampler>());
+        };
+
+        // Starts requesting a sample from each attached thread every interval.
+        auto start()
+            -> void
+        {
+            this->timer = std::jthread([this](std::stop_token token)
+            {
+                while(!token.stop_requested())
+                {
+                    std::this_thread::sleep_for(this->interval);
+
+                    std::scoped_lock lock(this->mutex);
+                    for(auto& sampler: this->samplers)
+                    {
+                        sampler->pending.store(true, std::memory_order_relaxed);
+                    };
+                };
+            });
+        };
+
+        // Stops requesting samples.
+        auto stop()
+            -> void
+        {
+            this->timer.request_stop();
+
+            if(this->timer.joinable())
+            {
+                this->timer.join();
+            };
+        };
+
+        // Unwinds the guest call stack by walking the saved base pointer chain.
+        template<const auto& arch> static auto unwind(ThreadContext<arch>& ctx)
+            -> prof::Sample
+        {
+            prof::Sample sample{};
+            sample.frames[sample.depth++] = ctx.get_data().ip;
+
+            const auto& frame = ctx.stack_frame;
+            const auto  top   = frame.vaddr + frame.size;
+
+            // Each frame holds the callers base pointer at `bp`, and its return ip above it.
+            for(auto bp = frame.bp; sample.depth < prof::max_depth && bp >= frame.vaddr && bp + 2uz * sizeof(std::size_t) <= top;)
+            {
+                auto slice_result = ctx.process->mem->template slice<std::size_t>(bp, 2uz * sizeof(std::size_t));
+
+                if(!slice_result)
+                {
+                    break;
+                };
+
+                auto [saved_bp, return_ip] = slice_result->shared([](const auto& span)
+                {
+                    return std::pair{span[0], span[1]};
+                });
+
+                sample.frames[sample.depth++] = return_ip;
+
+                // The chain must move towards the top of the stack.
+                if(saved_bp <= bp)
+                {
+                    break;
+                };
+
+                bp = saved_bp;
+            };
+
+            return sample;
+        };
+
+        // Safepoint; records a sample if one was requested. Called by the guest thread between instructions,
+        // as `Tiered::run` does on entering each block.
+        template<const auto& arch> static auto poll(prof::Sampler& sampler, ThreadContext<arch>& ctx)
+            -> void
+        {
+            if(!sampler.pending.load(std::memory_order_relaxed)) [[likely]]
+            {
+                return;
+            };
+
+            sampler.pending.store(false, std::memory_order_relaxed);
+
+            if(!sampler.ring.push(Profiler::unwind(ctx)))
+            {
+                sampler.dropped.fetch_add(1uz, std::memory_order_relaxed);
+            };
+        };
+
+        // Drains the recorded samples into collapsed stacks (`root;...;leaf count`) for flamegraphs.
+        auto collapse(const prof::Symbols& symbols = {})
+            -> std::string
+        {   // Returns the function containing `ip`, or the ip itself.
+            auto symbolize = [&symbols](const std::size_t ip)
+                -> std::string
+            {
+                if(auto it = symbols.upper_bound(ip); it != symbols.begin())
+                {
+                    return std::prev(it)->second;
+                };
+
+                return std::format("{:#x}", ip);
+            };
+
+            std::map<std::string, std::size_t> stacks{};
+
+            std::scoped_lock lock(this->mutex);
+            for(auto& sampler: this->samplers)
+            {
+                while(auto sample = sampler->ring.pop())
+                {   // Frames are recorded leaf first.
+                    auto frames = std::span(sample->frames.data(), sample->depth)
+                        | std::views::reverse
+                        | std::views::transform(symbolize)
+                        | std::views::join_with(';')
+                        | std::ranges::to<std::string>();
+
+                    stacks[std::move(frames)] += 1uz;
+                };
+            };
+
+            std::string collapsed{};
+            for(const auto& [stack, count]: stacks)
+            {
+                std::format_to(std::back_inserter(collapsed), "{} {}\n", stack, count);
+            };
+
+            return collapsed;
+        };
+    };
+};
@@ -43,6 +43,14 @@ namespace mint
         StackFrame(std::size_t vaddr, std::size_t size)
             : sp(vaddr + size), bp(sp), vaddr(vaddr), size(size) {};
 
+        // Empties the stack, restoring the stack and base pointers to the top.
+        constexpr auto reset() noexcept
+            -> void
+        {
+            this->sp = this->vaddr + this->size;
+            this->bp = this->sp;
+        };
+
         // Ensures proper alignment for stack operations.
         constexpr auto align(std::size_t address, std::size_t alignment) const noexcept
             -> std::size_t
@@ -63,7 +71,7 @@ namespace mint
 
             this->sp -= data_size;
 
-            auto slice_result = mem.slice(this->sp, data_size);
+            auto slice_result = mem.slice(this->sp, data_size, mem::Flags::Write);
             if(!slice_result)
             {
                 return slice_result.error();
@@ -71,7 +79,7 @@ namespace mint
 
             if(auto copy_result = slice_result->copy(data); copy_result != 0u)
             {
-                return xxas::error(Err::Address, std::format("Failed to copy {} bytes to memory.", copy_result));
+                return xxas::error(Err::Address, "Failed to copy {} bytes to memory.", copy_result);
             };
 
             return {};
@@ -86,7 +94,7 @@ namespace mint
                 return xxas::error(Err::Underflow, "Stack underflow: Attempted to pop beyond allocated stack.");
             };
 
-            auto slice_result = mem.slice(this->sp, size);
+            auto slice_result = mem.slice(this->sp, size, mem::Flags::Read);
             if(!slice_result)
             {
                 return slice_result.error();
@@ -95,7 +103,7 @@ namespace mint
             std::vector<std::byte> data{size};
             if(auto copy_result = slice_result->clone(data); copy_result != 0u)
             {
-                return xxas::error(Err::Address, std::format("Failed to copy {} bytes to memory.", copy_result));
+                return xxas::error(Err::Address, "Failed to copy {} bytes to memory.", copy_result);
             };
 
             // Increment the stack pointer back to the top.
@@ -109,7 +117,9 @@ namespace mint
             -> Result<>
         {
             constexpr std::size_t alignment = alignof(T);
-            this->sp = align(this->sp - sizeof(T), alignment);
+
+            // Align the slot the value is pushed into; `push_bytes` moves the stack pointer onto it.
+            this->sp = align(this->sp - sizeof(T), alignment) + sizeof(T);
 
             std::span<const std::byte> data
             {
@@ -143,6 +153,7 @@ namespace mint
         };
 
         // Function prologue: save caller's state.
+        // The saved base pointer sits at `bp`, directly below the return ip pushed by the caller.
         auto function_prologue(Memory& mem)
             -> Result<>
         {   // Save previous base pointer.
@@ -0,0 +1,248 @@
+export module mint: tiered;
+
+import std;
+import xxas;
+
+import :context;
+import :instruction;
+import :dispatch;
+import :profiler;
+
+/*** **
+ **
+ **  module:   mint: tiered
+ **  purpose:  Tiered execution; blocks of instructions are interpreted until they
+ **            run often enough to be lowered into specialized handlers in the background.
+ **
+ *** **/
+
+namespace mint
+{
+    namespace tier
+    {   // Instructions per block; the unit executions are counted and promoted by.
+        export constexpr inline std::size_t default_block_size = 0x10;
+
+        // Executions of a block before it's promoted.
+        export constexpr inline std::size_t default_threshold = 0x40;
+
+        // Execution tier of a block.
+        export enum class State: std::uint8_t
+        {   // Interpreted, counting its executions.
+            Interpreted,
+
+            // Waiting to be lowered by the compiler thread.
+            Queued,
+
+            // Lowered handlers are published.
+            Compiled,
+
+            // Cannot be lowered; remains interpreted.
+            Rejected,
+        };
+    };
+
+    export template<const auto& arch> struct Tiered
+    {
+        using Dispatch = mint::Dispatch<arch>;
+        using Result   = typename Dispatch::Result;
+        using Lowered  = typename Dispatch::Lowered;
+
+        struct Block
+        {
+            std::atomic_size_t          count{};
+            std::atomic<tier::State>    state{tier::State::Interpreted};
+
+            // Swapped in once by the compiler thread; read by guest threads at each block entry.
+            std::atomic<const Lowered*> compiled{};
+        };
+
+        using BlockPtr   = std::unique_ptr<Block[]>;
+        using LoweredPtr = std::unique_ptr<Lowered>;
+        using LoweredVec = std::vector<LoweredPtr>;
+        using Queue      = std::deque<std::size_t>;
+
+        // Program being executed; must outlive the executor.
+        const Insns*                insns;
+
+        std::size_t                 block_size;
+        std::size_t                 threshold;
+        std::size_t                 block_count;
+        BlockPtr                    blocks;
+
+        // Handlers of every compiled block; only written by the compiler thread.
+        LoweredVec                  lowered{};
+
+        // Locks the queue and compiler state.
+        std::mutex                  mutex{};
+        std::condition_variable_any wake{};
+        std::condition_variable_any idle{};
+
+        // Blocks waiting to be lowered, and blocks being lowered.
+        Queue                       queue{};
+        std::size_t                 compiling{};
+
+        // Started by the first promotion; declared last so it stops before the state above is destroyed.
+        std::jthread                compiler{};
+
+        explicit Tiered(const Insns& insns, const std::size_t block_size = tier::default_block_size, const std::size_t threshold = tier::default_threshold)
+            : insns{&insns}, block_size{std::max(block_size, 1uz)}, threshold{std::max(threshold, 1uz)},
+              block_count{(insns.size() + this->block_size - 1uz) / this->block_size}, blocks{std::make_unique<Block[]>(this->block_count)} {};
+
+        // Returns the tier of the block at `index`.
+        auto state(const std::size_t index) const noexcept
+            -> tier::State
+        {
+            return this->blocks[index].state.load(std::memory_order_acquire);
+        };
+
+        // Runs the thread from its ip to the end of the program, stopping at the first failing instruction.
+        // With a `sampler`, the thread polls for profiler samples on entering each block.
+        auto run(ThreadContext<arch>& ctx, prof::Sampler* sampler = nullptr)
+            -> Result
+        {
+            auto& data = ctx.get_data();
+
+            while(data.ip < this->insns->size())
+            {
+                if(sampler)
+                {
+                    Profiler::poll(*sampler, ctx);
+                };
+
+                auto  index = data.ip / this->block_size;
+                auto  begin = index * this->block_size;
+                auto  end   = std::min(begin + this->block_size, this->insns->size());
+                auto& block = this->blocks[index];
+
+                if(auto* compiled = block.compiled.load(std::memory_order_acquire)) [[likely]]
+                {
+                    for(; data.ip < end; ++data.ip)
+                    {
+                        if(auto result = std::invoke((*compiled)[data.ip - begin], (*this->insns)[data.ip], ctx); !result)
+                        {
+                            return result;
+                        };
+                    };
+
+                    continue;
+                };
+
+                this->count(index);
+
+                for(; data.ip < end; ++data.ip)
+                {
+                    if(auto result = Dispatch::execute((*this->insns)[data.ip], ctx); !result)
+                    {
+                        return result;
+                    };
+                };
+            };
+
+            return {};
+        };
+
+        // Blocks until every queued block is lowered.
+        auto flush()
+            -> void
+        {
+            std::unique_lock lock(this->mutex);
+            this->idle.wait(lock, [this]
+            {
+                return this->queue.empty() && this->compiling == 0uz;
+            });
+        };
+
+        // Counts an interpreted execution of the block, promoting it once it crosses the threshold.
+        auto count(const std::size_t index)
+            -> void
+        {
+            auto& block = this->blocks[index];
+
+            if(block.count.fetch_add(1uz, std::memory_order_relaxed) + 1uz != this->threshold) [[likely]]
+            {
+                return;
+            };
+
+            auto expected = tier::State::Interpreted;
+            if(!block.state.compare_exchange_strong(expected, tier::State::Queued, std::memory_order_relaxed))
+            {
+                return;
+            };
+
+            {
+                std::scoped_lock lock(this->mutex);
+                this->queue.push_back(index);
+
+                if(!this->compiler.joinable())
+                {
+                    this->compiler = std::jthread([this](std::stop_token token)
+                    {
+                        this->compile_loop(token);
+                    });
+                };
+            };
+
+            this->wake.notify_one();
+        };
+
+        // Lowers queued blocks until stopped.
+        auto compile_loop(std::stop_token token)
+            -> void
+        {
+            while(true)
+            {
+                auto index = 0uz;
+                {
+                    std::unique_lock lock(this->mutex);
+                    if(!this->wake.wait(lock, token, [this] { return !this->queue.empty(); }))
+                    {
+                        return;
+                    };
+
+                    index = this->queue.front();
+                    this->queue.pop_front();
+                    this->compiling = this->compiling + 1uz;
+                };
+
+                this->compile(index);
+
+                {
+                    std::scoped_lock lock(this->mutex);
+                    this->compiling = this->compiling - 1uz;
+                };
+
+                this->idle.notify_all();
+            };
+        };
+
+        // Lowers the block at `index` and swaps its handlers in.
+        auto compile(const std::size_t index)
+            -> void
+        {
+            auto& block = this->blocks[index];
+            auto  begin = index * this->block_size;
+            auto  end   = std::min(begin + this->block_size, this->insns->size());
+
+            auto handlers = std::make_unique<Lowered>();
+            handlers->reserve(end - begin);
+
+            for(auto ip = begin; ip < end; ++ip)
+            {
+                auto handler = Dispatch::find((*this->insns)[ip]);
+
+                if(!handler)
+                {
+                    block.state.store(tier::State::Rejected, std::memory_order_release);
+                    return;
+                };
+
+                handlers->push_back(*handler);
+            };
+
+            block.compiled.store(handlers.get(), std::memory_order_release);
+            block.state.store(tier::State::Compiled, std::memory_order_release);
+
+            this->lowered.push_back(std::move(handlers));
+        };
+    };
+};
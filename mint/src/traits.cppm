@@ -45,6 +45,26 @@ namespace mint
             Mask = 0b00000001,
         };
 
+        // Returns the position of a single source within `Register`, `Immediate` and `Memory`;
+        // sources of several or no bits, such as `Any`, are positioned past `Memory`.
+        export constexpr auto index(const Source source) noexcept
+            -> std::size_t
+        {
+            if(!std::has_single_bit(std::to_underlying(source)))
+            {
+                return std::numeric_limits<std::size_t>::max();
+            };
+
+            return std::countr_zero(std::to_underlying(source)) - std::countr_zero(std::to_underlying(Source::Register));
+        };
+
+        // Returns the position of a bitness within `b8` through `b512`.
+        export constexpr auto index(const Bitness bitness) noexcept
+            -> std::size_t
+        {
+            return (std::to_underlying(bitness) >> 1) - 1uz;
+        };
+
         template<class T, class... Ts> constexpr auto popcount()
             -> bool
         {   // Count the amount of bits flipped to '1'.
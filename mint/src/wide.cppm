@@ -0,0 +1,682 @@
+export module mint: wide;
+
+import std;
+import xxas;
+
+/*** **
+ **
+ **  module:   mint: wide
+ **  purpose:  Constexpr fixed-width unsigned integers of 128 to 512 bits, built
+ **            from carry-chained 64-bit limbs.
+ **
+ *** **/
+
+namespace mint
+{
+    namespace wide
+    {
+        export using Limb = std::uint64_t;
+
+        // Limbs from which full products are split in halves, rather than multiplied limb by limb.
+        export constexpr inline std::size_t karatsuba_limbs = 8uz;
+
+        // Adds `a`, `b` and a carry in; returns the carry out.
+        constexpr auto add_carry(const Limb a, const Limb b, const Limb carry, Limb& out) noexcept
+            -> Limb
+        {
+            auto sum   = a + b;
+            auto first = static_cast<Limb>(sum < a);
+
+            out = sum + carry;
+            return first | static_cast<Limb>(out < sum);
+        };
+
+        // Subtracts `b` and a borrow in from `a`; returns the borrow out.
+        constexpr auto sub_borrow(const Limb a, const Limb b, const Limb borrow, Limb& out) noexcept
+            -> Limb
+        {
+            auto diff  = a - b;
+            auto first = static_cast<Limb>(a < b);
+
+            out = diff - borrow;
+            return first | static_cast<Limb>(diff < borrow);
+        };
+
+        // Returns the low limb of `a * b`, storing its high limb into `high`.
+        constexpr auto mul_limb(const Limb a, const Limb b, Limb& high) noexcept
+            -> Limb
+        {
+          #ifdef __SIZEOF_INT128__
+            auto product = static_cast<unsigned __int128>(a) * b;
+
+            high = static_cast<Limb>(product >> 64);
+            return static_cast<Limb>(product);
+          #else
+            // Multiply 32-bit halves.
+            constexpr Limb mask = 0xffff'ffffu;
+
+            auto ll  = (a & mask) * (b & mask);
+            auto lh  = (a & mask) * (b >> 32);
+            auto hl  = (a >> 32) * (b & mask);
+            auto hh  = (a >> 32) * (b >> 32);
+            auto mid = (ll >> 32) + (lh & mask) + (hl & mask);
+
+            high = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+            return (mid << 32) | (ll & mask);
+          #endif
+        };
+
+        // Adds `src` into `dst`, carrying through the rest of `dst`; returns the carry out of `dst`.
+        constexpr auto add_limbs(std::span<Limb> dst, std::span<const Limb> src) noexcept
+            -> Limb
+        {
+            Limb carry = 0u;
+            for(auto n = 0uz; n < dst.size() && (n < src.size() || carry != 0u); ++n)
+            {
+                carry = wide::add_carry(dst[n], n < src.size() ? src[n] : Limb{0}, carry, dst[n]);
+            };
+
+            return carry;
+        };
+
+        // Subtracts `src` from `dst`, borrowing through the rest of `dst`; returns the borrow out of `dst`.
+        constexpr auto sub_limbs(std::span<Limb> dst, std::span<const Limb> src) noexcept
+            -> Limb
+        {
+            Limb borrow = 0u;
+            for(auto n = 0uz; n < dst.size() && (n < src.size() || borrow != 0u); ++n)
+            {
+                borrow = wide::sub_borrow(dst[n], n < src.size() ? src[n] : Limb{0}, borrow, dst[n]);
+            };
+
+            return borrow;
+        };
+
+        // Schoolbook product of `a` and `b` into `out`, which holds `a.size() + b.size()` zeroed limbs.
+        constexpr auto mul_limbs(std::span<Limb> out, std::span<const Limb> a, std::span<const Limb> b) noexcept
+            -> void
+        {
+            for(auto i = 0uz; i < a.size(); ++i)
+            {
+                Limb carry = 0u;
+                for(auto j = 0uz; j < b.size(); ++j)
+                {   // `out + a * b + carry` always fits two limbs.
+                    Limb high = 0u;
+                    auto low  = wide::mul_limb(a[i], b[j], high);
+
+                    high  = high + wide::add_carry(out[i + j], low, 0u, out[i + j]);
+                    high  = high + wide::add_carry(out[i + j], carry, 0u, out[i + j]);
+                    carry = high;
+                };
+
+                out[i + b.size()] = carry;
+            };
+        };
+
+        // Full product of two integers of `N` limbs; split in halves by Karatsuba from `karatsuba_limbs` limbs.
+        export template<std::size_t N> constexpr auto multiply(const std::array<Limb, N>& a, const std::array<Limb, N>& b) noexcept
+            -> std::array<Limb, N * 2uz>
+        {
+            std::array<Limb, N * 2uz> out{};
+
+            if constexpr(N < karatsuba_limbs || N % 2uz != 0uz)
+            {
+                wide::mul_limbs(out, a, b);
+            }
+            else
+            {   // With a = a1 * B + a0 and b = b1 * B + b0; a * b = z2 * B^2 + (z1 - z2 - z0) * B + z0,
+                // where z1 = (a0 + a1) * (b0 + b1), trading a product of halves for additions.
+                constexpr auto H = N / 2uz;
+
+                std::array<Limb, H> a0{}, a1{}, b0{}, b1{};
+                std::ranges::copy_n(a.begin(),     H, a0.begin());
+                std::ranges::copy_n(a.begin() + H, H, a1.begin());
+                std::ranges::copy_n(b.begin(),     H, b0.begin());
+                std::ranges::copy_n(b.begin() + H, H, b1.begin());
+
+                auto z0 = wide::multiply<H>(a0, b0);
+                auto z2 = wide::multiply<H>(a1, b1);
+
+                // Sums of the halves, with their carries applied apart.
+                auto sa = a0;
+                auto sb = b0;
+                auto ca = wide::add_limbs(sa, a1);
+                auto cb = wide::add_limbs(sb, b1);
+
+                std::array<Limb, N + 2uz> z1{};
+                std::ranges::copy(wide::multiply<H>(sa, sb), z1.begin());
+
+                if(ca != 0u)
+                {
+                    wide::add_limbs(std::span(z1).subspan(H), sb);
+                };
+
+                if(cb != 0u)
+                {
+                    wide::add_limbs(std::span(z1).subspan(H), sa);
+                };
+
+                if(ca != 0u && cb != 0u)
+                {
+                    wide::add_limbs(std::span(z1).subspan(N), std::array<Limb, 1uz>{1u});
+                };
+
+                wide::sub_limbs(z1, z0);
+                wide::sub_limbs(z1, z2);
+
+                std::ranges::copy(z0, out.begin());
+                std::ranges::copy(z2, out.begin() + N);
+                wide::add_limbs(std::span(out).subspan(H), z1);
+            };
+
+            return out;
+        };
+
+        // Divides `u` by the nonzero `v`, returning the quotient; `u` is left holding the remainder.
+        export template<std::size_t N> constexpr auto divide(std::array<Limb, N>& u, const std::array<Limb, N>& v) noexcept
+            -> std::array<Limb, N>
+        {
+            std::array<Limb, N> q{};
+
+            // Significant limbs of the divisor and dividend.
+            auto n = N;
+            while(n > 0uz && v[n - 1uz] == 0u)
+            {
+                --n;
+            };
+
+            auto m = N;
+            while(m > 0uz && u[m - 1uz] == 0u)
+            {
+                --m;
+            };
+
+            if(n == 0uz || m < n)
+            {
+                return q;
+            };
+
+          #ifdef __SIZEOF_INT128__
+            using Double = unsigned __int128;
+            using Signed = __int128;
+
+            if(n == 1uz)
+            {   // Short division by a single limb.
+                Double rem = 0u;
+                for(auto i = m; i-- > 0uz;)
+                {
+                    auto num = (rem << 64) | u[i];
+
+                    q[i] = static_cast<Limb>(num / v[0]);
+                    rem  = num % v[0];
+                };
+
+                u.fill(0u);
+                u[0] = static_cast<Limb>(rem);
+
+                return q;
+            };
+
+            // Knuth's algorithm D; normalize so the divisor's top limb has its high bit set.
+            auto shift = static_cast<std::size_t>(std::countl_zero(v[n - 1uz]));
+            auto funnel = [shift](const Limb high, const Limb low)
+                -> Limb
+            {
+                return shift == 0uz ? high : (high << shift) | (low >> (64uz - shift));
+            };
+
+            std::array<Limb, N>       vn{};
+            std::array<Limb, N + 1uz> un{};
+
+            for(auto i = n - 1uz; i > 0uz; --i)
+            {
+                vn[i] = funnel(v[i], v[i - 1uz]);
+            };
+            vn[0] = v[0] << shift;
+
+            un[m] = funnel(0u, u[m - 1uz]);
+            for(auto i = m - 1uz; i > 0uz; --i)
+            {
+                un[i] = funnel(u[i], u[i - 1uz]);
+            };
+            un[0] = u[0] << shift;
+
+            constexpr Double base = Double{1} << 64;
+
+            for(auto j = m - n + 1uz; j-- > 0uz;)
+            {   // Estimate the quotient limb from the top two limbs, then correct it at most twice.
+                auto num  = (Double{un[j + n]} << 64) | un[j + n - 1uz];
+                auto qhat = num / vn[n - 1uz];
+                auto rhat = num % vn[n - 1uz];
+
+                while(qhat >= base || qhat * vn[n - 2uz] > ((rhat << 64) | un[j + n - 2uz]))
+                {
+                    qhat = qhat - 1u;
+                    rhat = rhat + vn[n - 1uz];
+
+                    if(rhat >= base)
+                    {
+                        break;
+                    };
+                };
+
+                // Multiply and subtract.
+                Signed borrow = 0;
+                Signed t      = 0;
+                for(auto i = 0uz; i < n; ++i)
+                {
+                    auto product = qhat * vn[i];
+
+                    t         = static_cast<Signed>(un[i + j]) - borrow - static_cast<Signed>(static_cast<Limb>(product));
+                    un[i + j] = static_cast<Limb>(t);
+                    borrow    = static_cast<Signed>(product >> 64) - (t >> 64);
+                };
+
+                t         = static_cast<Signed>(un[j + n]) - borrow;
+                un[j + n] = static_cast<Limb>(t);
+                q[j]      = static_cast<Limb>(qhat);
+
+                // Subtracted too much; add a divisor back.
+                if(t < 0)
+                {
+                    q[j] = q[j] - 1u;
+
+                    Limb back = 0u;
+                    for(auto i = 0uz; i < n; ++i)
+                    {
+                        back = wide::add_carry(un[i + j], vn[i], back, un[i + j]);
+                    };
+
+                    un[j + n] = un[j + n] + back;
+                };
+            };
+
+            // Denormalize the remainder.
+            u.fill(0u);
+            for(auto i = 0uz; i + 1uz < n; ++i)
+            {
+                u[i] = shift == 0uz ? un[i] : (un[i] >> shift) | (un[i + 1uz] << (64uz - shift));
+            };
+            u[n - 1uz] = un[n - 1uz] >> shift;
+          #else
+            // Restoring binary long division.
+            std::array<Limb, N> r{};
+            for(auto bit = m * 64uz; bit-- > 0uz;)
+            {
+                auto top = r[N - 1uz] >> 63;
+                for(auto i = N; i-- > 1uz;)
+                {
+                    r[i] = (r[i] << 1) | (r[i - 1uz] >> 63);
+                };
+                r[0] = (r[0] << 1) | ((u[bit / 64uz] >> (bit % 64uz)) & 1u);
+
+                if(top != 0u || !std::ranges::lexicographical_compare(r | std::views::reverse, v | std::views::reverse))
+                {
+                    wide::sub_limbs(r, v);
+                    q[bit / 64uz] = q[bit / 64uz] | (Limb{1} << (bit % 64uz));
+                };
+            };
+
+            u = r;
+          #endif
+
+            return q;
+        };
+    };
+
+    // Unsigned integer of `Bits` bits, with the wrapping arithmetic of the builtin unsigned integers.
+    export template<std::size_t Bits> requires(Bits > 64uz && Bits % 64uz == 0uz) struct Wide
+    {
+        using Limb  = wide::Limb;
+        using Limbs = std::array<Limb, Bits / 64uz>;
+
+        constexpr static inline std::size_t bits  = Bits;
+        constexpr static inline std::size_t count = Bits / 64uz;
+
+        // Least significant limb first; the byte layout of a little-endian guest register.
+        Limbs limbs{};
+
+        constexpr Wide() noexcept = default;
+
+        template<std::unsigned_integral T> constexpr Wide(const T value) noexcept
+            : limbs{static_cast<Limb>(value)} {};
+
+        // Sign extends negative values.
+        template<std::signed_integral T> constexpr Wide(const T value) noexcept
+        {
+            this->limbs.fill(value < 0 ? ~Limb{0} : Limb{0});
+            this->limbs[0] = static_cast<Limb>(value);
+        };
+
+        // Truncates or zero extends another width.
+        template<std::size_t B> constexpr explicit Wide(const Wide<B>& other) noexcept
+        {
+            std::ranges::copy_n(other.limbs.begin(), std::min(count, Wide<B>::count), this->limbs.begin());
+        };
+
+        // Truncates to the low bits.
+        template<std::integral T> requires(!std::same_as<T, bool>) constexpr explicit operator T() const noexcept
+        {
+            return static_cast<T>(this->limbs[0]);
+        };
+
+        constexpr explicit operator bool() const noexcept
+        {
+            return std::ranges::any_of(this->limbs, [](const Limb limb) { return limb != 0u; });
+        };
+
+        constexpr static auto max() noexcept
+            -> Wide
+        {
+            Wide wide{};
+            wide.limbs.fill(~Limb{0});
+
+            return wide;
+        };
+
+        // Returns the quotient and remainder; dividing by zero gives all ones, and leaves the dividend as the remainder.
+        constexpr static auto divmod(const Wide& dividend, const Wide& divisor) noexcept
+            -> std::pair<Wide, Wide>
+        {
+            if(!divisor)
+            {
+                return {Wide::max(), dividend};
+            };
+
+            auto remainder = dividend;
+            auto quotient  = Wide{};
+            quotient.limbs = wide::divide(remainder.limbs, divisor.limbs);
+
+            return {quotient, remainder};
+        };
+
+        // Full product of twice the width.
+        constexpr static auto multiply(const Wide& a, const Wide& b) noexcept
+            -> Wide<Bits * 2uz>
+        {
+            Wide<Bits * 2uz> product{};
+            product.limbs = wide::multiply(a.limbs, b.limbs);
+
+            return product;
+        };
+
+        friend constexpr auto operator==(const Wide&, const Wide&) noexcept -> bool = default;
+
+        friend constexpr auto operator<=>(const Wide& a, const Wide& b) noexcept
+            -> std::strong_ordering
+        {
+            for(auto n = count; n-- > 0uz;)
+            {
+                if(a.limbs[n] != b.limbs[n])
+                {
+                    return a.limbs[n] <=> b.limbs[n];
+                };
+            };
+
+            return std::strong_ordering::equal;
+        };
+
+        friend constexpr auto operator+(Wide a, const Wide& b) noexcept
+            -> Wide
+        {
+            wide::add_limbs(a.limbs, b.limbs);
+            return a;
+        };
+
+        friend constexpr auto operator-(Wide a, const Wide& b) noexcept
+            -> Wide
+        {
+            wide::sub_limbs(a.limbs, b.limbs);
+            return a;
+        };
+
+        // Schoolbook product of the low limbs only; the high half of the full product is never computed.
+        friend constexpr auto operator*(const Wide& a, const Wide& b) noexcept
+            -> Wide
+        {
+            Wide out{};
+            for(auto i = 0uz; i < count; ++i)
+            {
+                Limb carry = 0u;
+                for(auto j = 0uz; i + j < count; ++j)
+                {
+                    Limb high = 0u;
+                    auto low  = wide::mul_limb(a.limbs[i], b.limbs[j], high);
+
+                    high  = high + wide::add_carry(out.limbs[i + j], low, 0u, out.limbs[i + j]);
+                    high  = high + wide::add_carry(out.limbs[i + j], carry, 0u, out.limbs[i + j]);
+                    carry = high;
+                };
+            };
+
+            return out;
+        };
+
+        friend constexpr auto operator/(const Wide& a, const Wide& b) noexcept
+            -> Wide
+        {
+            return Wide::divmod(a, b).first;
+        };
+
+        friend constexpr auto operator%(const Wide& a, const Wide& b) noexcept
+            -> Wide
+        {
+            return Wide::divmod(a, b).second;
+        };
+
+        friend constexpr auto operator&(Wide a, const Wide& b) noexcept
+            -> Wide
+        {
+            std::ranges::transform(a.limbs, b.limbs, a.limbs.begin(), std::bit_and{});
+            return a;
+        };
+
+        friend constexpr auto operator|(Wide a, const Wide& b) noexcept
+            -> Wide
+        {
+            std::ranges::transform(a.limbs, b.limbs, a.limbs.begin(), std::bit_or{});
+            return a;
+        };
+
+        friend constexpr auto operator^(Wide a, const Wide& b) noexcept
+            -> Wide
+        {
+            std::ranges::transform(a.limbs, b.limbs, a.limbs.begin(), std::bit_xor{});
+            return a;
+        };
+
+        friend constexpr auto operator~(Wide a) noexcept
+            -> Wide
+        {
+            std::ranges::transform(a.limbs, a.limbs.begin(), std::bit_not{});
+            return a;
+        };
+
+        friend constexpr auto operator-(const Wide& a) noexcept
+            -> Wide
+        {
+            return ~a + Wide{1u};
+        };
+
+        friend constexpr auto operator<<(const Wide& a, const std::size_t shift) noexcept
+            -> Wide
+        {
+            Wide out{};
+            if(shift >= Bits)
+            {
+                return out;
+            };
+
+            auto limbs = shift / 64uz;
+            auto rest  = shift % 64uz;
+
+            for(auto n = count; n-- > limbs;)
+            {
+                out.limbs[n] = a.limbs[n - limbs] << rest;
+
+                if(rest != 0uz && n > limbs)
+                {
+                    out.limbs[n] = out.limbs[n] | (a.limbs[n - limbs - 1uz] >> (64uz - rest));
+                };
+            };
+
+            return out;
+        };
+
+        friend constexpr auto operator>>(const Wide& a, const std::size_t shift) noexcept
+            -> Wide
+        {
+            Wide out{};
+            if(shift >= Bits)
+            {
+                return out;
+            };
+
+            auto limbs = shift / 64uz;
+            auto rest  = shift % 64uz;
+
+            for(auto n = 0uz; n + limbs < count; ++n)
+            {
+                out.limbs[n] = a.limbs[n + limbs] >> rest;
+
+                if(rest != 0uz && n + limbs + 1uz < count)
+                {
+                    out.limbs[n] = out.limbs[n] | (a.limbs[n + limbs + 1uz] << (64uz - rest));
+                };
+            };
+
+            return out;
+        };
+
+        constexpr auto operator+=(const Wide& other) noexcept -> Wide& { return *this = *this + other; };
+        constexpr auto operator-=(const Wide& other) noexcept -> Wide& { return *this = *this - other; };
+        constexpr auto operator*=(const Wide& other) noexcept -> Wide& { return *this = *this * other; };
+        constexpr auto operator/=(const Wide& other) noexcept -> Wide& { return *this = *this / other; };
+        constexpr auto operator%=(const Wide& other) noexcept -> Wide& { return *this = *this % other; };
+        constexpr auto operator&=(const Wide& other) noexcept -> Wide& { return *this = *this & other; };
+        constexpr auto operator|=(const Wide& other) noexcept -> Wide& { return *this = *this | other; };
+        constexpr auto operator^=(const Wide& other) noexcept -> Wide& { return *this = *this ^ other; };
+
+        constexpr auto operator<<=(const std::size_t shift) noexcept -> Wide& { return *this = *this << shift; };
+        constexpr auto operator>>=(const std::size_t shift) noexcept -> Wide& { return *this = *this >> shift; };
+
+        constexpr auto operator++() noexcept -> Wide& { return *this += Wide{1u}; };
+        constexpr auto operator--() noexcept -> Wide& { return *this -= Wide{1u}; };
+    };
+
+    export using u128 = Wide<128uz>;
+    export using u256 = Wide<256uz>;
+    export using u512 = Wide<512uz>;
+
+    namespace wide
+    {
+        template<class T> constexpr inline bool is_wide = false;
+        template<std::size_t Bits> constexpr inline bool is_wide<Wide<Bits>> = true;
+
+        // Wide unsigned integer type.
+        export template<class T> concept integer = is_wide<std::remove_cv_t<T>>;
+
+        // Saturating counterparts of `std::add_sat`, `std::sub_sat`, `std::mul_sat` and `std::div_sat`.
+        export template<std::size_t Bits> constexpr auto add_sat(Wide<Bits> a, const Wide<Bits>& b) noexcept
+            -> Wide<Bits>
+        {
+            return wide::add_limbs(a.limbs, b.limbs) != 0u ? Wide<Bits>::max() : a;
+        };
+
+        export template<std::size_t Bits> constexpr auto sub_sat(Wide<Bits> a, const Wide<Bits>& b) noexcept
+            -> Wide<Bits>
+        {
+            return wide::sub_limbs(a.limbs, b.limbs) != 0u ? Wide<Bits>{} : a;
+        };
+
+        export template<std::size_t Bits> constexpr auto mul_sat(const Wide<Bits>& a, const Wide<Bits>& b) noexcept
+            -> Wide<Bits>
+        {
+            auto product = Wide<Bits>::multiply(a, b);
+
+            // Any bit of the high half saturates.
+            if(std::ranges::any_of(product.limbs | std::views::drop(Wide<Bits>::count), [](const Limb limb) { return limb != 0u; }))
+            {
+                return Wide<Bits>::max();
+            };
+
+            return Wide<Bits>(product);
+        };
+
+        // Unsigned division cannot overflow; the divisor must be nonzero.
+        export template<std::size_t Bits> constexpr auto div_sat(const Wide<Bits>& a, const Wide<Bits>& b) noexcept
+            -> Wide<Bits>
+        {
+            return a / b;
+        };
+    };
+};
+
+// mint::Wide formatting; decimal by default, or hexadecimal with `x`.
+template<std::size_t Bits>
+struct std::formatter<mint::Wide<Bits>>
+{
+    bool hex{};
+
+    constexpr auto parse(std::format_parse_context& ctx)
+        -> decltype(ctx.begin())
+    {
+        auto it = ctx.begin();
+
+        if(it != ctx.end() && (*it == 'x' || *it == 'd'))
+        {
+            this->hex = *it == 'x';
+            ++it;
+        };
+
+        if(it != ctx.end() && *it != '}')
+        {
+            throw std::format_error("Invalid format specifier for Wide");
+        };
+
+        return it;
+    };
+
+    template<class Ctx> auto format(const mint::Wide<Bits>& value, Ctx& ctx) const
+    {
+        if(this->hex)
+        {   // Skip the leading zero limbs, then pad every following limb.
+            auto top = mint::Wide<Bits>::count - 1uz;
+            while(top > 0uz && value.limbs[top] == 0u)
+            {
+                --top;
+            };
+
+            auto out = std::format_to(ctx.out(), "{:x}", value.limbs[top]);
+            for(auto n = top; n-- > 0uz;)
+            {
+                out = std::format_to(out, "{:016x}", value.limbs[n]);
+            };
+
+            return out;
+        };
+
+        // Peel off 19 decimal digits at a time, the most a limb holds.
+        constexpr std::uint64_t chunk = 10'000'000'000'000'000'000u;
+
+        std::vector<std::uint64_t> chunks{};
+        auto rest = value;
+
+        do
+        {
+            auto [quotient, remainder] = mint::Wide<Bits>::divmod(rest, chunk);
+
+            chunks.push_back(remainder.limbs[0]);
+            rest = quotient;
+        }
+        while(rest);
+
+        auto out = std::format_to(ctx.out(), "{}", chunks.back());
+        for(auto n = chunks.size() - 1uz; n-- > 0uz;)
+        {
+            out = std::format_to(out, "{:019}", chunks[n]);
+        };
+
+        return out;
+    };
+};
@@ -49,9 +49,35 @@ namespace mint_test
         xxas::assert_eq(fl32, std::numbers::egamma_v<float>);
     };
 
+    void atomic_invocation()
+    {
+        alignas(std::atomic_ref<std::uint64_t>::required_alignment) std::uint64_t counter = 1;
+
+        std::vector<std::span<std::byte>> spans
+        {
+            {reinterpret_cast<std::byte*>(&counter), sizeof(std::uint64_t)},
+        };
+
+        std::function fn = [](std::atomic_ref<std::uint64_t> value)
+            -> Binding::Result
+        {
+            value.fetch_add(2u);
+            return {};
+        };
+
+        auto binding = Binding::create(fn, spans);
+        xxas::assert_eq(binding.has_value(), true);
+
+        // Each invocation operates atomically on the bound bytes.
+        xxas::assert_eq(std::invoke(*binding).has_value(), true);
+        xxas::assert_eq(std::invoke(*binding).has_value(), true);
+
+        xxas::assert_eq(counter, 5u);
+    };
+
     constexpr inline xxas::Tests bindings
     {
-        invocation,
+        invocation, atomic_invocation,
     };
 };
 
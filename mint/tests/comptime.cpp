@@ -0,0 +1,222 @@
+import std;
+import xxas;
+import mint;
+
+#include "fixture.hpp"
+
+namespace mint_tests
+{
+    using namespace mint;
+
+    constexpr static auto keywords = arch::Keywords
+    {   // Registers.
+        std::pair{"gp0", Traits{traits::Bitness::b64,  traits::Source::Register}},
+        std::pair{"gp1", Traits{traits::Bitness::b64,  traits::Source::Register}},
+        std::pair{"gp2", Traits{traits::Bitness::b64,  traits::Source::Register}},
+        std::pair{"xd0", Traits{traits::Bitness::b128, traits::Source::Register}},
+    };
+
+    constexpr static auto insns = arch::Insns
+    {
+        std::pair{"mov", [](auto& dest, const auto& src) -> void {
+            dest = src;
+        }},
+        std::pair{"add", [](auto& dest, const auto& a, const auto& b) -> void {
+            dest = a + b;
+        }},
+        std::pair{"mul", [](auto& dest, const auto& a, const auto& b) -> void {
+            dest = a * b;
+        }},
+        // Writes its destination before reading its source; shows operands sharing a register alias.
+        std::pair{"swap_add", [](auto& dest, auto& src) -> void {
+            auto old = dest;
+            dest     = src;
+            src      = src + old;
+        }},
+    };
+
+    constexpr inline Arch arch
+    {
+        insns, keywords
+    };
+
+    using Machine = Comptime<arch, 0x200uz>;
+
+    constexpr Traits imm64  = {traits::Bitness::b64,  traits::Source::Immediate};
+    constexpr Traits mem64  = {traits::Bitness::b64,  traits::Source::Memory};
+    constexpr Traits imm128 = {traits::Bitness::b128, traits::Source::Immediate};
+    constexpr Traits mem8   = {traits::Bitness::b8,   traits::Source::Memory};
+
+    constexpr std::size_t entries = 0x20uz;
+
+    // Generates a table of the squares of 0 through `entries`, one 64-bit word each, from the image base.
+    constexpr auto squares = []
+    {
+        comptime::Code<entries * 3uz + 4uz> code{};
+        auto it = code.begin();
+
+        *it++ = Machine::insn("mov", Machine::reg("gp0"), comptime::Operand{imm64, 0u});
+        *it++ = Machine::insn("mov", Machine::reg("gp2"), comptime::Operand{imm64, 1u});
+
+        for(auto n = 0uz; n < entries; ++n)
+        {
+            *it++ = Machine::insn("mul", Machine::reg("gp1"), Machine::reg("gp0"), Machine::reg("gp0"));
+            *it++ = Machine::insn("mov", comptime::Operand{mem64, mem::default_base_addr + n * 8uz}, Machine::reg("gp1"));
+            *it++ = Machine::insn("add", Machine::reg("gp0"), Machine::reg("gp0"), Machine::reg("gp2"));
+        };
+
+        // A 128-bit square, and aliased operands.
+        *it++ = Machine::insn("mul", Machine::reg("xd0"), comptime::Operand{imm128, ~std::uint64_t{0}}, comptime::Operand{imm128, ~std::uint64_t{0}});
+        *it++ = Machine::insn("swap_add", Machine::reg("gp2"), Machine::reg("gp2"));
+
+        return code;
+    }();
+
+    // Precomputed during compilation; no instruction runs at startup.
+    constexpr auto table = Machine::segment(squares);
+
+    static_assert(table.read<std::uint64_t>(mem::default_base_addr)              == 0u);
+    static_assert(table.read<std::uint64_t>(mem::default_base_addr + 7uz * 8uz)  == 49u);
+    static_assert(table.read<std::uint64_t>(mem::default_base_addr + 31uz * 8uz) == 961u);
+
+    // The register file after the same program.
+    constexpr auto machine = []
+    {
+        Machine machine{};
+        machine.run(squares).value();
+
+        return machine;
+    }();
+
+    static_assert(machine.read<std::uint64_t>("gp0") == entries);
+    static_assert(machine.read<u128>("xd0") == u128{~std::uint64_t{0}} * u128{~std::uint64_t{0}});
+
+    // Both operands name gp2; the instruction sees a single word, as a handler does.
+    static_assert(machine.read<std::uint64_t>("gp2") == 2u);
+
+    // Failures are returned as they are at runtime.
+    static_assert([]
+    {
+        comptime::Code<1uz> code{Machine::insn("mov", comptime::Operand{mem64, 0u}, Machine::reg("gp0"))};
+
+        Machine machine{};
+        auto    result = machine.run(code);
+
+        return !result && std::holds_alternative<Memory::Err>(result.error().type) && machine.ip == 0uz;
+    }());
+
+    static_assert([]
+    {   // A byte operand is written alone, truncated from the word, as `Dispatch` writes it.
+        comptime::Code<2uz> code
+        {
+            Machine::insn("mov", comptime::Operand{mem64, mem::default_base_addr}, comptime::Operand{imm64, ~std::uint64_t{0}}),
+            Machine::insn("mov", comptime::Operand{mem8,  mem::default_base_addr}, comptime::Operand{imm64, 0x1234u}),
+        };
+
+        Machine machine{};
+        machine.run(code).value();
+
+        return machine.image.read<std::uint64_t>(mem::default_base_addr) == ((~std::uint64_t{0} << 8u) | 0x34u);
+    }());
+
+    static_assert([]
+    {   // A 128-bit operand reaches past a 64-bit register.
+        comptime::Code<1uz> code{Machine::insn("mov", Machine::reg("gp0"), comptime::Operand{imm128, 1u})};
+
+        Machine machine{};
+        auto    result = machine.run(code);
+
+        return !result && std::holds_alternative<Operand::Err>(result.error().type);
+    }());
+
+    // Creates a thread context with the image allocated at its base.
+    auto image_context()
+        -> ThreadContext<arch>
+    {
+        auto ctx   = thread_context<arch>();
+        auto image = ctx.process->mem->allocate(table.bytes.size());
+        xxas::assert(image.has_value(), "Image allocation should succeed");
+        xxas::assert_eq(*image, table.base);
+
+        return ctx;
+    };
+
+    void identical_results()
+    {   // Run the same program through the runtime IR and dispatch.
+        auto ctx     = image_context();
+        auto program = Machine::program(squares);
+
+        for(const auto& insn: program.insns)
+        {
+            xxas::assert(Dispatch<arch>::execute(insn, ctx).has_value(), "Instruction should execute");
+        };
+
+        auto slice = ctx.process->mem->slice(table.base, table.bytes.size());
+        xxas::assert(slice.has_value(), "Image should be readable");
+        xxas::assert(std::ranges::equal(slice->span, table.bytes), "Runtime memory should match the constexpr segment");
+
+        for(const auto name: {"gp0", "gp1", "gp2"})
+        {
+            xxas::assert_eq(read<std::uint64_t>(ctx, name), machine.read<std::uint64_t>(name));
+        };
+
+        xxas::assert(read<u128>(ctx, "xd0") == machine.read<u128>("xd0"), "Wide registers should match");
+    };
+
+    void runtime_interpretation()
+    {   // The constexpr interpreter also runs at runtime, to the same image.
+        Machine runtime{};
+        xxas::assert(runtime.run(squares).has_value(), "Program should run");
+        xxas::assert(runtime.image.bytes == table.bytes, "Runtime interpretation should match the constexpr segment");
+    };
+
+    void mapped_segment()
+    {   // The segment is mapped in place, read-only.
+        Memory memory{};
+
+        auto vaddr = memory.map_static(table.bytes);
+        xxas::assert(vaddr.has_value(), "Segment should map");
+
+        auto entry = memory.slice<std::uint64_t>(*vaddr + 12uz * 8uz, sizeof(std::uint64_t), mem::Flags::Read);
+        xxas::assert(entry.has_value(), "Mapped segment should be readable");
+        xxas::assert_eq(entry->span[0], 144u);
+        xxas::assert(static_cast<const void*>(entry->span.data()) == static_cast<const void*>(table.bytes.data() + 12uz * 8uz), "Segment should be mapped without copying");
+
+        xxas::assert(!memory.slice(*vaddr, 8uz, mem::Flags::Write).has_value(), "Mapped segment should be read-only");
+    };
+
+    void mapped_segment_stores()
+    {   // Guest loads from the segment succeed, and stores to it fault without reaching it.
+        auto ctx   = image_context();
+        auto vaddr = ctx.process->mem->map_static(table.bytes);
+        xxas::assert(vaddr.has_value(), "Segment should map");
+
+        auto load = Machine::program(comptime::Code<1uz>{Machine::insn("mov", Machine::reg("gp1"), comptime::Operand{mem64, *vaddr + 12uz * 8uz})});
+        xxas::assert(Dispatch<arch>::execute(load.insns.front(), ctx).has_value(), "Load from the segment should execute");
+        xxas::assert_eq(read<std::uint64_t>(ctx, "gp1"), 144u);
+
+        auto store  = Machine::program(comptime::Code<1uz>{Machine::insn("mov", comptime::Operand{mem64, *vaddr}, Machine::reg("gp1"))});
+        auto result = Dispatch<arch>::execute(store.insns.front(), ctx);
+
+        xxas::assert(!result.has_value(), "Store to the segment should fault");
+        xxas::assert(std::holds_alternative<Memory::Err>(result.error().type), "Store should fault with a memory error");
+        xxas::assert(std::get<Memory::Err>(result.error().type) == Memory::Err::NoPermission, "Store should lack permission");
+
+        auto entry = ctx.process->mem->slice<std::uint64_t>(*vaddr, sizeof(std::uint64_t), mem::Flags::Read);
+        xxas::assert(entry.has_value(), "Mapped segment should be readable");
+        xxas::assert_eq(entry->span[0], 0u);
+    };
+
+    constexpr xxas::Tests comptime
+    {
+        identical_results,
+        runtime_interpretation,
+        mapped_segment,
+        mapped_segment_stores,
+    };
+};
+
+int main()
+{
+    return mint_tests::comptime();
+};
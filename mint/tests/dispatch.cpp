@@ -0,0 +1,255 @@
+import std;
+import xxas;
+import mint;
+
+#include "fixture.hpp"
+
+namespace mint_tests
+{
+    using namespace mint;
+
+    constexpr static auto keywords = arch::Keywords
+    {   // Registers.
+        std::pair{"gp0", Traits{traits::Bitness::b64, traits::Source::Register}},
+        std::pair{"gp1", Traits{traits::Bitness::b64, traits::Source::Register}},
+        std::pair{"gp2", Traits{traits::Bitness::b64, traits::Source::Register}},
+
+        // Misc keywords.
+        std::pair{"dword", Traits{traits::Bitness::b64}},
+        std::pair{"ptr",   Traits{traits::Source::Memory}},
+    };
+
+    constexpr static auto insns = arch::Insns
+    {
+        std::pair{"mov", [](auto& dest, const auto& src) -> void {
+            dest = src;
+        }},
+        std::pair{"add", [](auto& dest, const auto& a, const auto& b) -> void {
+            dest = a + b;
+        }},
+    };
+
+    constexpr inline Arch arch
+    {
+        insns, keywords
+    };
+
+    // Without wide registers, only words up to 64 bits are specialized.
+    static_assert(dispatch::widths<arch> == traits::index(traits::Bitness::b64) + 1uz);
+
+    constexpr Traits reg64 = {traits::Bitness::b64, traits::Source::Register};
+    constexpr Traits imm64 = {traits::Bitness::b64, traits::Source::Immediate};
+    constexpr Traits mem64 = {traits::Bitness::b64, traits::Source::Memory};
+
+    void specialized_execution()
+    {
+        auto ctx = thread_context<arch>(stack::default_size);
+
+        // Place a constant into guest memory.
+        auto data_alloc = ctx.process->mem->allocate(sizeof(std::uint64_t));
+        xxas::assert(data_alloc.has_value(), "Data allocation should succeed");
+
+        auto slice = ctx.process->mem->slice<std::uint64_t>(*data_alloc, sizeof(std::uint64_t), mem::Flags::Write);
+        xxas::assert_eq(slice->copy(std::array<std::uint64_t, 1>{3}), 0u);
+
+        // Keyword indices of the registers, and the operand values.
+        std::size_t    gp0   = 0uz;
+        std::size_t    gp1   = 1uz;
+        std::uint64_t  imm   = 0xff;
+        std::uintptr_t vaddr = *data_alloc;
+
+        // mov gp0, 0xff
+        Instruction mov{.opcode = 0uz};
+        mov.operands.push_back(operand(Scalar::from(gp0), reg64));
+        mov.operands.push_back(operand(Scalar::from(imm), imm64));
+
+        // add gp1, gp0, ptr[data]
+        Instruction add{.opcode = 1uz};
+        add.operands.push_back(operand(Scalar::from(gp1), reg64));
+        add.operands.push_back(operand(Scalar::from(gp0), reg64));
+        add.operands.push_back(operand(Scalar::from(vaddr), mem64));
+
+        Insns program{};
+        program.push_back(std::move(mov));
+        program.push_back(std::move(add));
+
+        // Lower the program into its specialized handlers once, then only index them.
+        auto lowered = Dispatch<arch>::lower(program);
+        xxas::assert(lowered.has_value(), "Program should lower into specialized handlers");
+
+        for(const auto& [handler, insn]: std::views::zip(*lowered, program))
+        {
+            xxas::assert(std::invoke(handler, insn, ctx).has_value(), "Handler should execute");
+        };
+
+        auto& gp1_reg = ctx.get_data().registers.at("gp1");
+        xxas::assert_eq(Scalar{{gp1_reg.data(), gp1_reg.size()}}.as<std::uint64_t>(), 258u);
+    };
+
+    void unsupported_operands()
+    {
+        std::size_t gp0 = 0uz;
+
+        // mov with a missing source operand.
+        Instruction mov{.opcode = 0uz};
+        mov.operands.push_back(operand(Scalar::from(gp0), reg64));
+
+        auto handler = Dispatch<arch>::find(mov);
+        xxas::assert_eq(handler.has_value(), false);
+        xxas::assert_eq(std::holds_alternative<Dispatch<arch>::Err>(handler.error().type), true);
+
+        // Opcode outside of the instruction set.
+        Instruction missing{.opcode = insns.entries.size()};
+        xxas::assert_eq(Dispatch<arch>::find(missing).has_value(), false);
+
+        // An operand of any source isn't taken to be a register.
+        constexpr Traits any64 = {traits::Bitness::b64, traits::Source::Any};
+
+        Instruction any{.opcode = 0uz};
+        any.operands.push_back(operand(Scalar::from(gp0), reg64));
+        any.operands.push_back(operand(Scalar::from(gp0), any64));
+        xxas::assert_eq(Dispatch<arch>::find(any).has_value(), false);
+    };
+
+    void unknown_registers()
+    {
+        auto ctx   = thread_context<arch>(stack::default_size);
+        auto count = ctx.get_data().registers.size();
+
+        // Ids past the keywords, and keywords that aren't registers.
+        std::size_t   past  = keywords.entries.size();
+        std::size_t   dword = 3uz;
+        std::uint64_t imm   = 1u;
+
+        for(auto* regid: {&past, &dword})
+        {
+            Instruction mov{.opcode = 0uz};
+            mov.operands.push_back(operand(Scalar::from(*regid), reg64));
+            mov.operands.push_back(operand(Scalar::from(imm), imm64));
+
+            auto result = Dispatch<arch>::execute(mov, ctx);
+            xxas::assert_eq(result.has_value(), false);
+            xxas::assert_eq(std::holds_alternative<Operand::Err>(result.error().type), true);
+        };
+
+        // Failed lookups don't insert registers.
+        xxas::assert_eq(ctx.get_data().registers.size(), count);
+    };
+
+    void guest_stores()
+    {
+        auto ctx    = thread_context<arch>(stack::default_size);
+        auto memory = ctx.process->mem;
+
+        auto data_alloc = memory->allocate(sizeof(std::uint64_t));
+        xxas::assert(data_alloc.has_value(), "Data allocation should succeed");
+
+        // Operands carry no direction; the store must still mark its page.
+        std::uintptr_t vaddr = *data_alloc;
+        std::uint64_t  imm   = 0xff;
+
+        // mov ptr[data], 0xff
+        Instruction mov{.opcode = 0uz};
+        mov.operands.push_back(operand(Scalar::from(vaddr), mem64));
+        mov.operands.push_back(operand(Scalar::from(imm), imm64));
+
+        memory->checkpoint();
+        xxas::assert(Dispatch<arch>::execute(mov, ctx).has_value(), "Store should execute");
+        xxas::assert(memory->pages.back().dirty->load(), "Guest stores should dirty pages");
+
+        memory->reset();
+
+        auto slice = memory->slice<std::uint64_t>(vaddr, sizeof(std::uint64_t));
+        xxas::assert(slice.has_value(), "Memory slice should succeed");
+        xxas::assert_eq(*slice->load(), std::uint64_t{0});
+    };
+
+    void guest_loads()
+    {
+        auto ctx    = thread_context<arch>(stack::default_size);
+        auto memory = ctx.process->mem;
+
+        auto data_alloc = memory->allocate(sizeof(std::uint64_t));
+        xxas::assert(data_alloc.has_value(), "Data allocation should succeed");
+
+        std::size_t    gp0   = 0uz;
+        std::uintptr_t vaddr = *data_alloc;
+
+        // mov gp0, ptr[data]
+        Instruction mov{.opcode = 0uz};
+        mov.operands.push_back(operand(Scalar::from(gp0), reg64));
+        mov.operands.push_back(operand(Scalar::from(vaddr), mem64));
+
+        // Source operands are only sliced for reading, so loads leave their page clean.
+        memory->checkpoint();
+        xxas::assert(Dispatch<arch>::execute(mov, ctx).has_value(), "Load should execute");
+        xxas::assert(!memory->pages.back().dirty->load(), "Guest loads shouldn't dirty pages");
+    };
+
+    void narrow_memory()
+    {
+        auto ctx    = thread_context<arch>(stack::default_size);
+        auto memory = ctx.process->mem;
+
+        // Guest bytes around the operand, which a 64-bit word would overwrite.
+        auto data_alloc = memory->allocate(0x10uz);
+        xxas::assert(data_alloc.has_value(), "Data allocation should succeed");
+
+        auto fill = memory->slice(*data_alloc, 0x10uz, mem::Flags::Write);
+        xxas::assert(fill.has_value(), "Memory slice should succeed");
+        std::ranges::fill(fill->span, std::byte{0xAA});
+
+        constexpr Traits mem8 = {traits::Bitness::b8, traits::Source::Memory};
+
+        std::size_t    gp0       = 0uz;
+        std::size_t    gp1       = 1uz;
+        std::uint64_t  imm       = 0x1122334455667788u;
+        std::uintptr_t vaddr     = *data_alloc;
+        std::uintptr_t unaligned = *data_alloc + 1uz;
+
+        // mov gp0, imm
+        Instruction load{.opcode = 0uz};
+        load.operands.push_back(operand(Scalar::from(gp0), reg64));
+        load.operands.push_back(operand(Scalar::from(imm), imm64));
+
+        // mov byte ptr[data], gp0
+        Instruction store{.opcode = 0uz};
+        store.operands.push_back(operand(Scalar::from(vaddr), mem8));
+        store.operands.push_back(operand(Scalar::from(gp0), reg64));
+
+        // mov gp1, ptr[data + 1]
+        Instruction read{.opcode = 0uz};
+        read.operands.push_back(operand(Scalar::from(gp1), reg64));
+        read.operands.push_back(operand(Scalar::from(unaligned), mem64));
+
+        for(const auto& insn: {std::cref(load), std::cref(store), std::cref(read)})
+        {
+            xxas::assert(Dispatch<arch>::execute(insn, ctx).has_value(), "Instruction should execute");
+        };
+
+        // Only the byte operand is written, truncated from the word.
+        auto bytes = memory->slice(*data_alloc, 0x10uz, mem::Flags::Read);
+        xxas::assert(bytes.has_value(), "Memory slice should succeed");
+        xxas::assert_eq(bytes->span[0], std::byte{0x88});
+        xxas::assert(std::ranges::all_of(bytes->span | std::views::drop(1uz), [](auto byte) { return byte == std::byte{0xAA}; }), "Neighbouring bytes should be kept");
+
+        // Unaligned words are read whole.
+        auto& gp1_reg = ctx.get_data().registers.at("gp1");
+        xxas::assert_eq(Scalar{{gp1_reg.data(), gp1_reg.size()}}.as<std::uint64_t>(), 0xAAAAAAAAAAAAAAAAu);
+    };
+
+    constexpr xxas::Tests dispatch
+    {
+        specialized_execution,
+        unsupported_operands,
+        unknown_registers,
+        guest_stores,
+        guest_loads,
+        narrow_memory,
+    };
+};
+
+int main()
+{
+    return mint_tests::dispatch();
+};
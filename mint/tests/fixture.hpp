@@ -0,0 +1,49 @@
+#pragma once
+
+// Thread contexts, operands and register reads shared by the tests; included after importing `std`, `xxas` and `mint`.
+namespace mint_tests
+{
+    // Creates an operand from a constant expression.
+    inline auto operand(mint::Scalar scalar, const mint::Traits traits)
+        -> mint::Operand
+    {
+        return mint::Operand{mint::Expression{std::move(scalar)}, traits};
+    };
+
+    // Creates a thread context with a single thread, and a stack of `stack_size` bytes unless it's zero.
+    template<const auto& arch> auto thread_context(const std::size_t stack_size = 0uz)
+        -> mint::ThreadContext<arch>
+    {
+        auto process = std::make_shared<mint::ProcessContext<arch>>(std::make_shared<mint::Cpu<arch>>(), std::make_shared<mint::Memory>());
+
+        process->cpu->threads.push_back(mint::Thread<arch>
+        {
+            .inner = std::thread{},
+            .data  = mint::ThreadData{.ip = 0, .registers = arch.get_registers()},
+        });
+
+        auto stack_vaddr = 0uz;
+        if(stack_size != 0uz)
+        {
+            auto stack_alloc = process->mem->allocate(stack_size);
+            xxas::assert(stack_alloc.has_value(), "Stack allocation should succeed");
+
+            stack_vaddr = *stack_alloc;
+        };
+
+        return mint::ThreadContext<arch>
+        {
+            .id          = 0uz,
+            .process     = std::move(process),
+            .stack_frame = mint::StackFrame(stack_vaddr, stack_size),
+        };
+    };
+
+    // Returns the value of the register named `name` of the thread.
+    template<class W, const auto& arch> auto read(mint::ThreadContext<arch>& ctx, const std::string_view name)
+        -> W
+    {
+        auto& reg = ctx.get_data().registers.at(name);
+        return mint::Scalar{{reg.data(), reg.size()}}.as<W>();
+    };
+};
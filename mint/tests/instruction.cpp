@@ -0,0 +1,134 @@
+import std;
+import xxas;
+import mint;
+
+namespace mint_tests
+{
+    using namespace mint;
+
+    // Memory resource counting the allocations and bytes requested from it.
+    struct Counting: std::pmr::memory_resource
+    {
+        std::size_t allocations{};
+        std::size_t bytes{};
+
+      private:
+        auto do_allocate(std::size_t size, std::size_t alignment)
+            -> void* override
+        {
+            this->allocations = this->allocations + 1uz;
+            this->bytes       = this->bytes + size;
+
+            return std::pmr::new_delete_resource()->allocate(size, alignment);
+        };
+
+        auto do_deallocate(void* ptr, std::size_t size, std::size_t alignment)
+            -> void override
+        {
+            std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+        };
+
+        auto do_is_equal(const std::pmr::memory_resource& other) const noexcept
+            -> bool override
+        {
+            return this == &other;
+        };
+    };
+
+    constexpr static std::size_t insn_count = 64uz;
+
+    constexpr Traits reg64 = {traits::Bitness::b64, traits::Source::Register};
+    constexpr Traits mem64 = {traits::Bitness::b64, traits::Source::Memory};
+
+    // Loads `insn_count` instructions of `add gp0, ptr[base + index * 8]` into `insns`, allocating from `resource`.
+    auto load(Insns& insns, std::pmr::memory_resource* resource)
+        -> void
+    {
+        static std::size_t    gp0   = 0uz;
+        static std::uintptr_t base  = 0x2000;
+        static std::uintptr_t index = 4;
+        static std::uintptr_t align = sizeof(std::uint64_t);
+
+        expr::Tokens tokens
+        {
+            {Scalar::from(base),  {}},
+            {Scalar::from(index), expr::Operator::Add},
+            {Scalar::from(align), expr::Operator::Mul},
+        };
+
+        for(std::size_t n = 0uz; n < insn_count; ++n)
+        {
+            auto address = Expression::parse(tokens, resource);
+            xxas::assert(address.has_value(), "Expression should parse");
+
+            Instruction::Operands operands{resource};
+            operands.push_back(Operand{Expression{Scalar::from(gp0), resource}, reg64});
+            operands.push_back(Operand{std::move(*address), mem64});
+
+            insns.emplace_back(1uz, std::move(operands));
+        };
+    };
+
+    void arena_allocations()
+    {   // Every node, operand range and instruction is allocated individually.
+        Counting heap{};
+        {
+            Insns insns{&heap};
+            load(insns, &heap);
+
+            std::println("heap:  {} allocations ({} bytes) per instruction",
+                static_cast<double>(heap.allocations) / insn_count, heap.bytes / insn_count);
+        };
+
+        // The entire program shares a single monotonic buffer.
+        Counting upstream{};
+        {
+            Program program{ir::default_arena_size, &upstream};
+            load(program.insns, program.arena());
+
+            std::println("arena: {} allocations ({} bytes) per instruction",
+                static_cast<double>(upstream.allocations) / insn_count, upstream.bytes / insn_count);
+        };
+
+        xxas::assert(upstream.allocations < heap.allocations, "Arena should allocate less often than the heap");
+    };
+
+    void arena_evaluation()
+    {
+        std::array<std::uint64_t, 4> array{1, 2, 3, 4};
+
+        auto base  = reinterpret_cast<std::uintptr_t>(array.data());
+        auto index = std::uintptr_t{2};
+        auto align = std::uintptr_t{sizeof(std::uint64_t)};
+
+        expr::Tokens tokens
+        {
+            {Scalar::from(base),  {}},
+            {Scalar::from(index), expr::Operator::Add},
+            {Scalar::from(align), expr::Operator::Mul},
+        };
+
+        Program program{};
+        auto expression = program.expression(tokens);
+        xxas::assert(expression.has_value(), "Expression should parse");
+
+        auto operands = program.operands();
+        operands.push_back(Operand{std::move(*expression), mem64});
+
+        auto& insn = program.push(0uz, std::move(operands));
+        auto value = *reinterpret_cast<std::uint64_t*>(insn.operands.front().expression.evaluate<std::uintptr_t>());
+
+        xxas::assert_eq(value, array[index]);
+    };
+
+    constexpr xxas::Tests instruction
+    {
+        arena_allocations,
+        arena_evaluation,
+    };
+};
+
+int main()
+{
+    return mint_tests::instruction();
+};
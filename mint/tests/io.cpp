@@ -0,0 +1,201 @@
+#include <unistd.h>
+
+import std;
+import xxas;
+import mint;
+
+namespace mint_tests
+{
+    using namespace mint;
+
+    // Interval long enough that only explicit flushes write output.
+    constexpr static std::chrono::milliseconds idle{std::chrono::hours{1}};
+
+    // Reads everything currently written to a pipe.
+    auto drain(const int fd)
+        -> std::string
+    {
+        std::string output(0x1000, '\0');
+        auto read = ::read(fd, output.data(), output.size());
+
+        output.resize(read > 0 ? static_cast<std::size_t>(read) : 0uz);
+        return output;
+    };
+
+    void ordered_lines()
+    {
+        std::array<int, 2> fds{};
+        xxas::assert_eq(::pipe(fds.data()), 0);
+        {
+            Channel channel{io::Mode::Ordered, fds[1], io::default_threshold, idle};
+
+            channel.write(0uz, "a");
+            channel.println(1uz, "{}", 2);
+            channel.write(0uz, "c");
+            channel.flush();
+
+            xxas::assert_eq(drain(fds[0]), std::string("a\n2\nc\n"));
+        };
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    };
+
+    void held_lines()
+    {
+        std::array<int, 2> fds{};
+        xxas::assert_eq(::pipe(fds.data()), 0);
+        {
+            Channel channel{io::Mode::Ordered, fds[1], io::default_threshold, idle};
+
+            // A line numbered past the watermark, as if numbered during a flush; held until the lines before it.
+            channel.write(0uz, "a");
+            {
+                auto& buffer = channel.buffer(1uz);
+                buffer.bytes = "z\n";
+                buffer.lines.emplace_back(2u, buffer.bytes.size());
+            };
+
+            channel.flush();
+            xxas::assert_eq(drain(fds[0]), std::string("a\n"));
+
+            channel.write(0uz, "b");
+            channel.sequence.fetch_add(1u);
+            channel.write(0uz, "c");
+            channel.flush();
+
+            xxas::assert_eq(drain(fds[0]), std::string("b\nz\nc\n"));
+        };
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    };
+
+    void unordered_batches()
+    {
+        std::array<int, 2> fds{};
+        xxas::assert_eq(::pipe(fds.data()), 0);
+        {
+            Channel channel{io::Mode::Unordered, fds[1], io::default_threshold, idle};
+
+            channel.write(0uz, "a");
+            channel.write(1uz, "b");
+            channel.write(0uz, "c");
+            channel.flush();
+
+            // Each thread batch is written contiguously.
+            xxas::assert_eq(drain(fds[0]), std::string("a\nc\nb\n"));
+        };
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    };
+
+    constexpr static auto keywords = arch::Keywords
+    {
+        std::pair{"gp0", Traits{traits::Bitness::b64, traits::Source::Register}},
+    };
+
+    constexpr static auto insns = arch::Insns
+    {
+        std::pair{"mov", [](auto& dest, const auto& src) -> void {
+            dest = src;
+        }},
+    };
+
+    constexpr inline Arch arch
+    {
+        insns, keywords
+    };
+
+    void unbound_process()
+    {   // A process without a channel writes to stdout, rather than through a previously bound channel.
+        std::array<int, 2> fds{};
+        xxas::assert_eq(::pipe(fds.data()), 0);
+        {
+            Channel channel{io::Mode::Ordered, fds[1], io::default_threshold, idle};
+            io::bind(channel, 0uz);
+
+            auto process = std::make_shared<ProcessContext<arch>>(std::make_shared<Cpu<arch>>(), std::make_shared<Memory>());
+            auto ctx     = ThreadContext<arch>{.id = 0uz, .process = std::move(process), .stack_frame = StackFrame(0uz, 0uz)};
+
+            ctx.bind_output();
+            io::println("unbound");
+
+            xxas::assert_eq(channel.buffer(0uz).lines.size(), 0uz);
+        };
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    };
+
+    void bound_threads()
+    {
+        std::array<int, 2> fds{};
+        xxas::assert_eq(::pipe(fds.data()), 0);
+        {
+            Channel channel{io::Mode::Ordered, fds[1], io::default_threshold, idle};
+
+            std::vector<std::thread> threads{};
+            for(auto id = 0uz; id < 4uz; ++id)
+            {
+                threads.emplace_back([&channel, id]
+                {
+                    io::bind(channel, id);
+
+                    for(auto n = 0; n < 8; ++n)
+                    {
+                        io::println("{}", id);
+                    };
+                });
+            };
+
+            for(auto& thread: threads)
+            {
+                thread.join();
+            };
+
+            channel.flush();
+
+            // Lines never interleave, and every line is written.
+            auto output = drain(fds[0]);
+            xxas::assert_eq(std::ranges::count(output, '\n'), 32);
+            xxas::assert_eq(output.size(), 64uz);
+        };
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    };
+
+    void write_errors()
+    {   // An invalid descriptor fails the write, rather than dropping output silently.
+        Channel channel{io::Mode::Unordered, -1, io::default_threshold, idle};
+        channel.write(0uz, "lost");
+
+        auto flushed = channel.flush();
+        xxas::assert_eq(flushed.has_value(), false);
+        xxas::assert(std::get<io::Err>(flushed.error().type) == io::Err::Write, "flushed.error() == Write");
+
+        // The error is kept until taken, as background flushes have nobody to return it to.
+        xxas::assert(channel.error().has_value(), "channel.error().has_value()");
+        xxas::assert_eq(channel.error().has_value(), false);
+
+        // Nothing is left to write.
+        xxas::assert(channel.flush().has_value(), "channel.flush().has_value()");
+    };
+
+    constexpr xxas::Tests output
+    {
+        ordered_lines,
+        held_lines,
+        unordered_batches,
+        unbound_process,
+        bound_threads,
+        write_errors,
+    };
+};
+
+int main()
+{
+    return mint_tests::output();
+};
@@ -21,7 +21,7 @@ namespace mint_tests
     constexpr static auto insns = arch::Insns
     {
         std::pair{"println", [](const auto& src) -> void { 
-            std::println("src: type: {}, value: {}", typeid(decltype(src)).name(), src); 
+            io::println("src: type: {}, value: {}", typeid(decltype(src)).name(), src); 
         }},
         std::pair{"mov", [](auto& dest, const auto& src) -> void { 
             dest = src; 
@@ -56,7 +56,7 @@ namespace mint_tests
         std::println("Data allocated at: {:#x}", *data_alloc);
 
         // Verify memory is writable.
-        auto slice = instance.inner.mem->slice<std::uint64_t>(*data_alloc, sizeof(std::uint64_t));
+        auto slice = instance.inner.mem->slice<std::uint64_t>(*data_alloc, sizeof(std::uint64_t), mem::Flags::Rw);
         xxas::assert(slice.has_value(), "Memory slice should succeed");
 
         std::uint64_t test_val = 0xDEADBEEF;
@@ -87,11 +87,155 @@ namespace mint_tests
         );
     };
 
+    void instance_pool_reuse()
+    {
+        // Allocate a stack and a data page once per instance.
+        auto builds = 0uz;
+        InstancePool<arch> pool{InstanceBuilder<arch>(), [&builds](Instance<arch>& instance)
+        {
+            xxas::assert(instance.stack().has_value(), "Stack allocation should succeed");
+            xxas::assert(instance.inner.mem->allocate(0x1000).has_value(), "Data allocation should succeed");
+
+            instance.inner.cpu->threads.push_back(Thread<arch>
+            {
+                .inner = std::thread{},
+                .data  = ThreadData{.ip = 0, .registers = arch.get_registers()},
+            });
+
+            ++builds;
+        }};
+
+        pool.reserve(1uz);
+
+        const Instance<arch>* first{};
+        std::uintptr_t        data{};
+        {
+            auto lease = pool.acquire();
+            first      = lease.instance.get();
+            data       = lease->inner.mem->pages.back().vaddr;
+
+            // Dirty a page, a register, and the stack.
+            auto slice = lease->inner.mem->slice<std::uint64_t>(data, sizeof(std::uint64_t), mem::Flags::Write);
+            xxas::assert(slice.has_value(), "Memory slice should succeed");
+            slice->store(0xDEADBEEF);
+
+            auto& thread = lease->inner.cpu->get_thread_data(0uz);
+            thread.ip = 0x40;
+            std::ranges::fill(thread.registers.at("gp0"), std::byte{0xFF});
+
+            xxas::assert(lease->stacks.front().push(*lease->inner.mem, 1uz).has_value(), "Stack push should succeed");
+        };
+
+        auto lease = pool.acquire();
+
+        // The same instance is handed out again, without being rebuilt.
+        xxas::assert_eq(lease.instance.get(), first);
+        xxas::assert_eq(builds, 1uz);
+
+        // Everything written by the previous job is cleared.
+        auto slice = lease->inner.mem->slice<std::uint64_t>(data, sizeof(std::uint64_t));
+        xxas::assert(slice.has_value(), "Memory slice should succeed");
+        xxas::assert_eq(*slice->load(), std::uint64_t{0});
+
+        auto& thread = lease->inner.cpu->get_thread_data(0uz);
+        xxas::assert_eq(thread.ip, 0uz);
+        xxas::assert(std::ranges::all_of(thread.registers.at("gp0"), [](auto byte) { return byte == std::byte{0}; }), "Registers should be zeroed");
+
+        const auto& frame = lease->stacks.front();
+        xxas::assert_eq(frame.sp, frame.vaddr + frame.size);
+        xxas::assert_eq(frame.bp, frame.sp);
+    };
+
+    void instance_pool_dirty_pages()
+    {
+        auto instance = InstanceBuilder<arch>().build();
+
+        auto alloc = instance.inner.mem->allocate(0x1000);
+        xxas::assert(alloc.has_value(), "Allocation should succeed");
+
+        const auto& page = instance.inner.mem->pages.front();
+        xxas::assert(!page.dirty->load(), "Fresh pages should be clean");
+
+        // Reading leaves the page clean; writing dirties it.
+        xxas::assert(instance.inner.mem->slice<std::uint64_t>(*alloc, sizeof(std::uint64_t)).has_value(), "Read slice should succeed");
+        xxas::assert(!page.dirty->load(), "Reads should not dirty pages");
+
+        auto slice = instance.inner.mem->slice<std::uint64_t>(*alloc, sizeof(std::uint64_t), mem::Flags::Write);
+        xxas::assert(slice.has_value(), "Write slice should succeed");
+        xxas::assert(page.dirty->load(), "Writes should dirty pages");
+
+        instance.reset();
+        xxas::assert(!page.dirty->load(), "Reset should clean pages");
+    };
+
+    void instance_pool_checkpoint()
+    {
+        // Setup leaves a value behind, which every job starts from.
+        InstancePool<arch> pool{InstanceBuilder<arch>(), [](Instance<arch>& instance)
+        {
+            xxas::assert(instance.stack().has_value(), "Stack allocation should succeed");
+
+            auto data = instance.inner.mem->allocate(sizeof(std::uint64_t));
+            xxas::assert(data.has_value(), "Data allocation should succeed");
+
+            auto slice = instance.inner.mem->slice<std::uint64_t>(*data, sizeof(std::uint64_t), mem::Flags::Write);
+            xxas::assert(slice.has_value(), "Memory slice should succeed");
+            slice->store(7u);
+        }};
+
+        auto lease = pool.acquire();
+        auto data  = lease->inner.mem->pages.back().vaddr;
+        auto pages = lease->inner.mem->pages.size();
+        auto next  = lease->inner.mem->next_addr.load();
+        {   // Overwrite the value, allocate and grow a stack during the job.
+            auto slice = lease->inner.mem->slice<std::uint64_t>(data, sizeof(std::uint64_t), mem::Flags::Write);
+            slice->store(9u);
+
+            xxas::assert(lease->inner.mem->allocate(0x1000).has_value(), "Job allocation should succeed");
+            xxas::assert(lease->stack().has_value(), "Job stack allocation should succeed");
+        };
+
+        lease->reset();
+
+        // The value, allocations and stacks are as setup left them.
+        auto slice = lease->inner.mem->slice<std::uint64_t>(data, sizeof(std::uint64_t));
+        xxas::assert(slice.has_value(), "Memory slice should succeed");
+        xxas::assert_eq(*slice->load(), std::uint64_t{7});
+
+        xxas::assert_eq(lease->inner.mem->pages.size(), pages);
+        xxas::assert_eq(lease->inner.mem->next_addr.load(), next);
+        xxas::assert_eq(lease->stacks.size(), 1uz);
+    };
+
+    void instance_stack_reset()
+    {
+        auto instance = InstanceBuilder<arch>().build();
+
+        auto frame = instance.stack();
+        xxas::assert(frame.has_value(), "Stack allocation should succeed");
+
+        // Frames handed out stay in place as more are allocated.
+        auto* stack = *frame;
+        xxas::assert(instance.stack().has_value(), "Second stack allocation should succeed");
+
+        instance.checkpoint();
+        xxas::assert(stack->push(*instance.inner.mem, std::uint64_t{0xff}).has_value(), "Push should succeed");
+        xxas::assert(stack->function_prologue(*instance.inner.mem).has_value(), "Prologue should succeed");
+
+        // The frame the thread pushed to is emptied, not a copy of it.
+        instance.reset();
+        xxas::assert_eq(stack->sp, stack->vaddr + stack->size);
+        xxas::assert_eq(stack->bp, stack->sp);
+    };
 
     constexpr xxas::Tests jit
     {
         jit_instance_creation,
         jit_thread_context_creation,
+        instance_pool_reuse,
+        instance_pool_dirty_pages,
+        instance_pool_checkpoint,
+        instance_stack_reset,
     };
 };
 
@@ -1,3 +1,6 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
 import std;
 import xxas;
 import mint;
@@ -32,7 +35,7 @@ namespace mint_tests
         std::ranges::iota(data.begin(), data.end(), 0x200);
 
         // Get a Shared<u32> slice and copy into it.
-        auto slice_result = memory.slice<std::uint32_t>(*alloc_result, 0x100);
+        auto slice_result = memory.slice<std::uint32_t>(*alloc_result, 0x100, mem::Flags::Rw);
         xxas::assert(slice_result.has_value(), "slice_result.has_value()");
 
         // copy returns number of bytes NOT written; expect zero.
@@ -57,7 +60,7 @@ namespace mint_tests
         xxas::assert(alloc_result.has_value(), "alloc_result.has_value()");
 
         // Get shared memory region as u32.
-        auto slice_result = memory.slice<std::uint32_t>(*alloc_result, 0x100 * 4);
+        auto slice_result = memory.slice<std::uint32_t>(*alloc_result, 0x100 * 4, mem::Flags::Rw);
         xxas::assert(slice_result.has_value(), "slice_result.has_value()");
 
         constexpr auto page_u32 = 0x100 / sizeof(std::uint32_t);
@@ -127,7 +130,7 @@ namespace mint_tests
 
         auto vaddr = *alloc_result;
 
-        auto slice_result = memory.slice<std::uint32_t>(vaddr, 0x100);
+        auto slice_result = memory.slice<std::uint32_t>(vaddr, 0x100, mem::Flags::Rw);
         xxas::assert(slice_result.has_value(), "slice_result.has_value()");
 
         // SIMD view.
@@ -153,9 +156,306 @@ namespace mint_tests
     };
 
 
+    // Writes `data` to a temporary file, returning its path.
+    auto temporary_file(const std::span<const std::uint32_t> data)
+        -> std::filesystem::path
+    {
+        auto path = std::filesystem::temp_directory_path() / std::format("mint_map_{}.bin", std::random_device{}());
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size_bytes());
+
+        return path;
+    };
+
+    auto mapped_file()
+    {
+        std::array<std::uint32_t, 4> data{1, 2, 3, 4};
+        auto path = temporary_file(data);
+
+        Memory memory{};
+
+        // Read-only mapping.
+        auto vaddr = memory.map_file(path);
+        xxas::assert(vaddr.has_value(), "vaddr.has_value()");
+
+        auto slice_result = memory.slice<std::uint32_t>(*vaddr, sizeof(data), mem::Flags::Read);
+        xxas::assert(slice_result.has_value(), "slice_result.has_value()");
+
+        auto out = std::array<std::uint32_t, 4>{};
+        xxas::assert_eq(slice_result->clone(out), 0u);
+        xxas::assert_eq(out, data);
+
+        // Writing to read-only pages is refused.
+        xxas::assert_eq(memory.slice<std::uint32_t>(*vaddr, sizeof(data), mem::Flags::Write).has_value(), false);
+
+        // Reading past the end of the mapping is refused.
+        xxas::assert_eq(memory.slice<std::uint32_t>(*vaddr, sizeof(data) * 2uz).has_value(), false);
+
+        // Private copy-on-write mapping.
+        auto cow_vaddr = memory.map_file(path, mem::Flags::Rw);
+        xxas::assert(cow_vaddr.has_value(), "cow_vaddr.has_value()");
+
+        auto cow_slice = memory.slice<std::uint32_t>(*cow_vaddr, sizeof(data), mem::Flags::Rw);
+        xxas::assert(cow_slice.has_value(), "cow_slice.has_value()");
+        xxas::assert_eq(cow_slice->copy(std::array<std::uint32_t, 4>{5, 6, 7, 8}), 0u);
+
+        // The file remains unchanged.
+        std::ifstream file(path, std::ios::binary);
+        file.read(reinterpret_cast<char*>(out.data()), sizeof(out));
+        xxas::assert_eq(out, data);
+
+        memory.free(*vaddr);
+        memory.free(*cow_vaddr);
+        std::filesystem::remove(path);
+    };
+
+    auto atomic_ops()
+    {
+        Memory memory{};
+
+        auto alloc_result = memory.allocate(sizeof(std::uint64_t), mem::Flags::Rw, alignof(std::uint64_t));
+        xxas::assert(alloc_result.has_value(), "alloc_result.has_value()");
+
+        auto slice_result = memory.slice<std::uint64_t>(*alloc_result, sizeof(std::uint64_t), mem::Flags::Rw);
+        xxas::assert(slice_result.has_value(), "slice_result.has_value()");
+        xxas::assert(slice_result->is_atomic(), "slice_result->is_atomic()");
+
+        xxas::assert(slice_result->store(0b0101, std::memory_order_release).has_value(), "store.has_value()");
+        xxas::assert_eq(*slice_result->fetch_or(0b1010), 0b0101u);
+        xxas::assert_eq(*slice_result->fetch_and(0b0011), 0b1111u);
+        xxas::assert_eq(*slice_result->fetch_add(4), 0b0011u);
+
+        // Compare-exchange fails, loading the current value into `expected`.
+        std::uint64_t expected = 0u;
+        xxas::assert_eq(*slice_result->compare_exchange(expected, 42u), false);
+        xxas::assert_eq(expected, 7u);
+        xxas::assert_eq(*slice_result->compare_exchange(expected, 42u), true);
+
+        mem::Shared<std::uint64_t>::fence(std::memory_order_acq_rel);
+        xxas::assert_eq(*slice_result->load(std::memory_order_acquire), 42u);
+
+        // Elements past the slice, or not aligned for atomics, are refused.
+        auto past = slice_result->load(std::memory_order_seq_cst, 1uz);
+        xxas::assert_eq(past.has_value(), false);
+        xxas::assert(std::get<mem::AtomicErr>(past.error().type) == mem::AtomicErr::OutOfRange, "past.error() == OutOfRange");
+
+        auto words = memory.allocate(sizeof(std::uint64_t) * 2uz, mem::Flags::Rw, alignof(std::uint64_t));
+        xxas::assert(words.has_value(), "words.has_value()");
+
+        auto unaligned = memory.slice<std::uint64_t>(*words + 1uz, sizeof(std::uint64_t), mem::Flags::Rw);
+        xxas::assert(unaligned.has_value(), "unaligned.has_value()");
+        xxas::assert_eq(unaligned->is_atomic(), false);
+
+        auto stored = unaligned->store(1u);
+        xxas::assert_eq(stored.has_value(), false);
+        xxas::assert(std::get<mem::AtomicErr>(stored.error().type) == mem::AtomicErr::Misaligned, "stored.error() == Misaligned");
+    };
+
+    // Compares contended increments of a single word through atomics, and through the page lock.
+    auto atomic_contention()
+    {
+        constexpr auto threads_count    = 4;
+        constexpr auto increments_count = 100'000;
+
+        Memory memory{};
+
+        auto alloc_result = memory.allocate(sizeof(std::uint64_t), mem::Flags::Rw, alignof(std::uint64_t));
+        xxas::assert(alloc_result.has_value(), "alloc_result.has_value()");
+
+        auto slice_result = memory.slice<std::uint64_t>(*alloc_result, sizeof(std::uint64_t), mem::Flags::Rw);
+        xxas::assert(slice_result.has_value(), "slice_result.has_value()");
+
+        auto contend = [&](auto&& increment)
+        {
+            slice_result->store(0u);
+
+            auto start   = std::chrono::steady_clock::now();
+            auto threads = std::vector<std::jthread>{};
+
+            for(auto t = 0; t < threads_count; ++t)
+            {
+                threads.emplace_back([&]
+                {
+                    for(auto n = 0; n < increments_count; ++n)
+                    {
+                        increment();
+                    };
+                });
+            };
+
+            threads.clear();
+
+            xxas::assert_eq(*slice_result->load(), static_cast<std::uint64_t>(threads_count * increments_count));
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        };
+
+        auto atomic = contend([&]
+        {
+            slice_result->fetch_add(1u, std::memory_order_relaxed);
+        });
+
+        auto locked = contend([&]
+        {
+            slice_result->exclusive([](auto& span)
+            {
+                span[0] = span[0] + 1u;
+            });
+        });
+
+        std::println("contended increments: atomic {}, page lock {}", atomic, locked);
+    };
+
+    // Slices never reach past their page into the next.
+    auto adjacent_pages()
+    {
+        Memory memory{};
+
+        // Unaligned, so the second page starts where the first ends.
+        auto first  = memory.allocate(sizeof(std::uint64_t), mem::Flags::Rw, 1uz);
+        auto second = memory.allocate(sizeof(std::uint64_t), mem::Flags::Rw, 1uz);
+        xxas::assert(first.has_value() && second.has_value(), "first.has_value() && second.has_value()");
+        xxas::assert_eq(*second, *first + sizeof(std::uint64_t));
+
+        auto slice = memory.slice<std::uint64_t>(*second, sizeof(std::uint64_t), mem::Flags::Write);
+        xxas::assert(slice.has_value(), "slice.has_value()");
+        slice->store(7u);
+
+        // Neither page reaches into the other.
+        xxas::assert_eq(memory.slice<std::uint64_t>(*first + 1uz, sizeof(std::uint64_t)).has_value(), false);
+        xxas::assert_eq(memory.slice<std::uint64_t>(*second + sizeof(std::uint64_t), sizeof(std::uint64_t)).has_value(), false);
+    };
+
+    // Runs against one address space from a child host process, and a read-only monitor.
+    auto shared_address_space()
+    {
+        auto name = std::format("/mint_shm_{}", ::getpid());
+
+        auto created = Memory::create_shared(name);
+        xxas::assert(created.has_value(), "created.has_value()");
+
+        auto& memory = **created;
+
+        auto alloc_result = memory.allocate(sizeof(std::uint64_t), mem::Flags::Rw, alignof(std::uint64_t));
+        xxas::assert(alloc_result.has_value(), "alloc_result.has_value()");
+
+        auto counter = memory.slice<std::uint64_t>(*alloc_result, sizeof(std::uint64_t), mem::Flags::Write);
+        xxas::assert(counter.has_value(), "counter.has_value()");
+        counter->store(1u);
+
+        // The child increments the shared counter, then allocates and writes a page of its own.
+        if(auto pid = ::fork(); pid == 0)
+        {
+            auto attached = Memory::attach_shared(name);
+            if(!attached)
+            {
+                ::_exit(1);
+            };
+
+            auto child_counter = (*attached)->slice<std::uint64_t>(*alloc_result, sizeof(std::uint64_t), mem::Flags::Write);
+            auto child_alloc   = (*attached)->allocate(sizeof(std::uint64_t), mem::Flags::Rw, alignof(std::uint64_t));
+            if(!child_counter || !child_alloc)
+            {
+                ::_exit(1);
+            };
+
+            child_counter->fetch_add(1u);
+
+            auto page = (*attached)->slice<std::uint64_t>(*child_alloc, sizeof(std::uint64_t), mem::Flags::Write);
+            if(!page)
+            {
+                ::_exit(1);
+            };
+
+            page->store(0xDEADBEEF);
+            ::_exit(0);
+        }
+        else
+        {
+            auto status = 0;
+            xxas::assert_eq(::waitpid(pid, &status, 0), pid);
+            xxas::assert(WIFEXITED(status) && WEXITSTATUS(status) == 0, "child process should succeed");
+        };
+
+        xxas::assert_eq(*counter->load(), 2uz);
+
+        // The childs page becomes visible once synced.
+        memory.sync();
+        xxas::assert_eq(memory.pages.size(), 2uz);
+
+        auto child_page = memory.slice<std::uint64_t>(memory.pages.back().vaddr, sizeof(std::uint64_t));
+        xxas::assert(child_page.has_value(), "child_page.has_value()");
+        xxas::assert_eq(*child_page->load(), 0xDEADBEEFuz);
+
+        // A monitor sees every page without copies, but can't write or allocate.
+        auto monitor = Memory::attach_shared(name, mem::Flags::Read);
+        xxas::assert(monitor.has_value(), "monitor.has_value()");
+
+        auto observed = (*monitor)->slice<std::uint64_t>(*alloc_result, sizeof(std::uint64_t), mem::Flags::Read);
+        xxas::assert(observed.has_value(), "observed.has_value()");
+        xxas::assert_eq(*observed->load(), 2uz);
+
+        xxas::assert_eq((*monitor)->slice<std::uint64_t>(*alloc_result, sizeof(std::uint64_t), mem::Flags::Write).has_value(), false);
+        xxas::assert_eq((*monitor)->allocate(0x100).has_value(), false);
+
+        // Unrelated shared memory objects are refused.
+        xxas::assert_eq(Memory::attach_shared(std::format("/mint_shm_missing_{}", ::getpid())).has_value(), false);
+    };
+
+    // Entries freed by every attachment holding them are reused, so allocation and attachment cycles don't exhaust the space.
+    auto shared_entry_reuse()
+    {
+        auto name = std::format("/mint_shm_reuse_{}", ::getpid());
+
+        auto created = Memory::create_shared(name);
+        xxas::assert(created.has_value(), "created.has_value()");
+
+        auto& memory = **created;
+        auto& header = *memory.region;
+
+        for(auto n = 0uz; n <= mem::shm::max_pages; ++n)
+        {
+            auto vaddr = memory.allocate(sizeof(std::uint64_t), mem::Flags::Rw, alignof(std::uint64_t));
+            xxas::assert(vaddr.has_value(), "vaddr.has_value()");
+
+            // Reused bytes read as zeroes.
+            auto slice = memory.slice<std::uint64_t>(*vaddr, sizeof(std::uint64_t), mem::Flags::Rw);
+            xxas::assert(slice.has_value(), "slice.has_value()");
+            xxas::assert_eq(*slice->load(), 0uz);
+            xxas::assert(slice->store(n + 1uz).has_value(), "store.has_value()");
+
+            {   // Attachments hold the page until they detach.
+                auto attached = Memory::attach_shared(name);
+                xxas::assert(attached.has_value(), "attached.has_value()");
+                xxas::assert_eq(header.entries[0].holders.load(), 2uz);
+            };
+
+            memory.free(*vaddr);
+        };
+
+        xxas::assert_eq(header.count.load(), 1uz);
+        xxas::assert_eq(header.entries[0].holders.load(), 0uz);
+
+        // A page freed by one attachment stays while another holds it.
+        auto held = memory.allocate(sizeof(std::uint64_t), mem::Flags::Rw, alignof(std::uint64_t));
+        xxas::assert(held.has_value(), "held.has_value()");
+
+        auto attached = Memory::attach_shared(name);
+        xxas::assert(attached.has_value(), "attached.has_value()");
+
+        memory.free(*held);
+
+        auto other = memory.allocate(sizeof(std::uint64_t), mem::Flags::Rw, alignof(std::uint64_t));
+        xxas::assert(other.has_value(), "other.has_value()");
+        xxas::assert_ne(*other, *held);
+        xxas::assert_eq(header.count.load(), 2uz);
+
+        xxas::assert((*attached)->slice<std::uint64_t>(*held, sizeof(std::uint64_t)).has_value(), "held page should remain attached");
+    };
+
     constexpr xxas::Tests memory
     {
-        awr, concurrent_rw, simd_par
+        awr, concurrent_rw, simd_par, mapped_file, atomic_ops, atomic_contention, adjacent_pages, shared_address_space, shared_entry_reuse
     };
 };
 
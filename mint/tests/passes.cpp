@@ -0,0 +1,347 @@
+import std;
+import xxas;
+import mint;
+
+#include "fixture.hpp"
+
+namespace mint_tests
+{
+    using namespace mint;
+
+    // Values written by the `out` instruction.
+    std::vector<std::uint64_t> outputs{};
+
+    constexpr static auto keywords = arch::Keywords
+    {   // Registers.
+        std::pair{"gp0", Traits{traits::Bitness::b64, traits::Source::Register}},
+        std::pair{"gp1", Traits{traits::Bitness::b64, traits::Source::Register}},
+        std::pair{"gp2", Traits{traits::Bitness::b64, traits::Source::Register}},
+        std::pair{"gp3", Traits{traits::Bitness::b64, traits::Source::Register}},
+    };
+
+    constexpr static auto insns = arch::Insns
+    {
+        std::pair{"mov", [](auto& dest, const auto& src) -> void {
+            dest = src;
+        }},
+        std::pair{"add", [](auto& dest, const auto& a, const auto& b) -> void {
+            dest = a + b;
+        }},
+        std::pair{"out", [](const auto& src) -> void {
+            outputs.push_back(src);
+        }},
+        std::pair{"mov.mov", [](auto& first, const auto& first_src, auto& second, const auto& second_src) -> void {
+            first  = first_src;
+            second = second_src;
+        }},
+        // Always faults, whatever its operands.
+        std::pair{"trap", [](auto&, const auto&) -> xxas::Error<Operand::Err> {
+            return xxas::error(Operand::Err::Casting, "Trapped");
+        }},
+    };
+
+    constexpr inline Arch arch
+    {
+        insns, keywords,
+
+        // `out` has effects, so declares nothing.
+        std::pair{"mov", arch::Legal::Move | arch::Legal::Fuse},
+        std::pair{"add", arch::Legal::Pure},
+
+        // Declared pure, but never folded, as it fails.
+        std::pair{"trap", arch::Legal::Pure},
+    };
+
+    // Opcodes, in declaration order.
+    constexpr std::size_t mov = 0uz, add = 1uz, out = 2uz, mov_mov = 3uz, trap = 4uz;
+
+    constexpr Traits reg64 = {traits::Bitness::b64, traits::Source::Register};
+    constexpr Traits imm64 = {traits::Bitness::b64, traits::Source::Immediate};
+
+    // Creates an operand over `value`, allocated from the program arena.
+    auto operand(Program& program, const std::uint64_t value, const Traits traits)
+        -> Operand
+    {
+        auto* bytes = static_cast<std::uint64_t*>(program.arena()->allocate(sizeof(value), alignof(std::uint64_t)));
+        *bytes = value;
+
+        return Operand{Expression{Scalar::from(*bytes), program.arena()}, traits};
+    };
+
+    auto reg(Program& program, const std::size_t id)
+        -> Operand
+    {
+        return operand(program, id, reg64);
+    };
+
+    auto imm(Program& program, const std::uint64_t value)
+        -> Operand
+    {
+        return operand(program, value, imm64);
+    };
+
+    template<class... Ops> auto emit(Program& program, const std::size_t opcode, Ops&&... ops)
+        -> void
+    {
+        auto operands = program.operands();
+        (operands.push_back(std::forward<Ops>(ops)), ...);
+
+        program.push(opcode, std::move(operands));
+    };
+
+    // Register values and output after running a program.
+    struct Outcome
+    {
+        std::array<std::uint64_t, 4> registers{};
+        std::vector<std::uint64_t>   output{};
+
+        auto operator==(const Outcome&) const -> bool = default;
+    };
+
+    // Lowers and runs the program `runs` times on a new thread.
+    auto execute(const Program& program, const std::size_t runs = 1uz)
+        -> Outcome
+    {
+        auto ctx = thread_context<arch>();
+
+        auto lowered = Dispatch<arch>::lower(program.insns);
+        xxas::assert(lowered.has_value(), "Program should lower");
+
+        outputs.clear();
+        for(auto n = 0uz; n < runs; ++n)
+        {
+            for(const auto& [handler, insn]: std::views::zip(*lowered, program.insns))
+            {
+                xxas::assert(std::invoke(handler, insn, ctx).has_value(), "Instruction should execute");
+            };
+        };
+
+        Outcome outcome{.output = std::exchange(outputs, {})};
+        for(auto id = 0uz; id < outcome.registers.size(); ++id)
+        {
+            auto& bytes = ctx.get_data().registers.at(keywords.entries[id].first);
+            outcome.registers[id] = Scalar{{bytes.data(), bytes.size()}}.as<std::uint64_t>();
+        };
+
+        return outcome;
+    };
+
+    // Returns the report of the pass named `name`.
+    auto report(const Optimizer<arch>::Reports& reports, const std::string_view name)
+        -> pass::Report
+    {
+        auto it = std::ranges::find(reports, name, &pass::Report::name);
+        xxas::assert(it != reports.end(), "Pass should report");
+
+        return *it;
+    };
+
+    void constant_folding()
+    {
+        auto build = []
+        {
+            Program program{};
+            emit(program, mov, reg(program, 0uz), imm(program, 2u));
+            emit(program, mov, reg(program, 1uz), imm(program, 3u));
+            emit(program, add, reg(program, 2uz), reg(program, 0uz), reg(program, 1uz));
+            emit(program, out, reg(program, 2uz));
+
+            return program;
+        };
+
+        auto original  = build();
+        auto optimized = build();
+
+        auto reports = Optimizer<arch>{.passes = {&Optimizer<arch>::propagate}}.run(optimized);
+
+        // The add of known registers is folded into a move of its result.
+        xxas::assert_eq(report(reports, "propagate").rewritten, 1uz);
+        xxas::assert_eq(optimized.insns[2].opcode, mov);
+        xxas::assert(execute(original) == execute(optimized), "Folding should preserve results");
+    };
+
+    void dead_and_redundant_moves()
+    {
+        auto build = []
+        {
+            Program program{};
+            emit(program, mov, reg(program, 0uz), imm(program, 1u));
+            emit(program, mov, reg(program, 0uz), reg(program, 0uz));
+            emit(program, mov, reg(program, 1uz), imm(program, 7u));
+            emit(program, mov, reg(program, 1uz), imm(program, 7u));
+            emit(program, mov, reg(program, 0uz), imm(program, 4u));
+            emit(program, out, reg(program, 0uz));
+
+            return program;
+        };
+
+        auto original  = build();
+        auto optimized = build();
+
+        auto reports = Optimizer<arch>{.passes = {&Optimizer<arch>::redundant_moves, &Optimizer<arch>::dead_stores}}.run(optimized);
+
+        // The self move and the repeated move, then the overwritten first move.
+        xxas::assert_eq(report(reports, "redundant_moves").removed, 2uz);
+        xxas::assert_eq(report(reports, "dead_stores").removed, 1uz);
+        xxas::assert_eq(optimized.insns.size(), 3uz);
+        xxas::assert(execute(original) == execute(optimized), "Removed moves should preserve results");
+    };
+
+    void superinstructions()
+    {
+        auto build = []
+        {
+            Program program{};
+            emit(program, mov, reg(program, 0uz), imm(program, 1u));
+            emit(program, mov, reg(program, 1uz), imm(program, 2u));
+            emit(program, out, reg(program, 0uz));
+
+            return program;
+        };
+
+        auto original  = build();
+        auto optimized = build();
+
+        auto reports = Optimizer<arch>{.passes = {&Optimizer<arch>::fuse}}.run(optimized);
+
+        xxas::assert_eq(report(reports, "fuse").rewritten, 1uz);
+        xxas::assert_eq(optimized.insns.size(), 2uz);
+        xxas::assert_eq(optimized.insns[0].opcode, mov_mov);
+        xxas::assert(execute(original) == execute(optimized), "Fusion should preserve results");
+    };
+
+    void undeclared_effects()
+    {   // Reads and writes through `out` are never reordered, removed, or propagated into.
+        Program program{};
+        emit(program, mov, reg(program, 0uz), imm(program, 1u));
+        emit(program, out, reg(program, 0uz));
+        emit(program, mov, reg(program, 0uz), imm(program, 1u));
+        emit(program, out, reg(program, 0uz));
+
+        auto reports = Optimizer<arch>{}.run(program);
+
+        xxas::assert_eq(program.insns.size(), 4uz);
+        for(const auto& [name, rewritten, removed]: reports)
+        {
+            xxas::assert_eq(rewritten + removed, 0uz);
+        };
+
+        xxas::assert_eq(execute(program).output, std::vector<std::uint64_t>{1u, 1u});
+    };
+
+    void undeclared_barriers()
+    {   // `out` may write any register, so values known before it aren't propagated past it.
+        Program program{};
+        emit(program, mov, reg(program, 1uz), imm(program, 2u));
+        emit(program, out, reg(program, 0uz));
+        emit(program, add, reg(program, 2uz), reg(program, 1uz), reg(program, 1uz));
+
+        auto reports = Optimizer<arch>{.passes = {&Optimizer<arch>::propagate}}.run(program);
+
+        xxas::assert_eq(report(reports, "propagate").rewritten, 0uz);
+        xxas::assert_eq(program.insns[2].opcode, add);
+    };
+
+    void failing_instructions()
+    {   // Folding `trap` would replace its fault with a move.
+        Program program{};
+        emit(program, mov, reg(program, 0uz), imm(program, 1u));
+        emit(program, trap, reg(program, 1uz), reg(program, 0uz));
+
+        auto reports = Optimizer<arch>{.passes = {&Optimizer<arch>::propagate}}.run(program);
+
+        // Its source is still propagated.
+        xxas::assert_eq(report(reports, "propagate").rewritten, 1uz);
+        xxas::assert_eq(program.insns[1].opcode, trap);
+
+        // Nor is `trap` removed when its result is overwritten, as its fault would be dropped.
+        Program stores{};
+        emit(stores, trap, reg(stores, 1uz), reg(stores, 0uz));
+        emit(stores, mov, reg(stores, 1uz), imm(stores, 5u));
+
+        reports = Optimizer<arch>{.passes = {&Optimizer<arch>::dead_stores}}.run(stores);
+
+        xxas::assert_eq(report(reports, "dead_stores").removed, 0uz);
+        xxas::assert_eq(stores.insns.front().opcode, trap);
+    };
+
+    void unknown_registers()
+    {   // Register ids past the keywords aren't known, nor taken to be overwritten.
+        Program program{};
+        emit(program, mov, reg(program, keywords.entries.size()), imm(program, 1u));
+        emit(program, mov, reg(program, keywords.entries.size()), imm(program, 2u));
+        emit(program, out, reg(program, keywords.entries.size()));
+
+        auto reports = Optimizer<arch>{.passes = {&Optimizer<arch>::propagate, &Optimizer<arch>::dead_stores}}.run(program);
+
+        xxas::assert_eq(report(reports, "propagate").rewritten, 0uz);
+        xxas::assert_eq(report(reports, "dead_stores").removed, 0uz);
+        xxas::assert_eq(program.insns.size(), 3uz);
+    };
+
+    // Reports instruction count and runtime reductions on a sample program.
+    void sample_program()
+    {
+        constexpr auto blocks = 0x100uz;
+        constexpr auto runs   = 0x100uz;
+
+        auto build = []
+        {   // Register setup, a computation on constants, copies, and an output per block.
+            Program program{};
+            for(auto n = 0uz; n < blocks; ++n)
+            {
+                emit(program, mov, reg(program, 0uz), imm(program, n));
+                emit(program, mov, reg(program, 1uz), imm(program, 1u));
+                emit(program, add, reg(program, 2uz), reg(program, 0uz), reg(program, 1uz));
+                emit(program, mov, reg(program, 3uz), reg(program, 3uz));
+                emit(program, mov, reg(program, 3uz), reg(program, 2uz));
+                emit(program, mov, reg(program, 1uz), imm(program, 1u));
+                emit(program, out, reg(program, 3uz));
+            };
+
+            return program;
+        };
+
+        auto original  = build();
+        auto optimized = build();
+
+        auto reports = Optimizer<arch>{}.run(optimized);
+        for(const auto& [name, rewritten, removed]: reports)
+        {
+            std::println("pass {}: {} rewritten, {} removed", name, rewritten, removed);
+        };
+
+        using Clock = std::chrono::steady_clock;
+
+        auto start    = Clock::now();
+        auto expected = execute(original, runs);
+        auto before   = Clock::now() - start;
+
+        start       = Clock::now();
+        auto actual = execute(optimized, runs);
+        auto after  = Clock::now() - start;
+
+        xxas::assert(expected == actual, "Optimized program should give the same results");
+        xxas::assert(optimized.insns.size() < original.insns.size(), "Optimized program should be smaller");
+
+        std::println("instructions: {} -> {}, runtime: {} -> {}", original.insns.size(), optimized.insns.size(),
+            std::chrono::duration_cast<std::chrono::microseconds>(before), std::chrono::duration_cast<std::chrono::microseconds>(after));
+    };
+
+    constexpr xxas::Tests passes
+    {
+        constant_folding,
+        dead_and_redundant_moves,
+        superinstructions,
+        undeclared_effects,
+        undeclared_barriers,
+        failing_instructions,
+        unknown_registers,
+        sample_program,
+    };
+};
+
+int main()
+{
+    return mint_tests::passes();
+};
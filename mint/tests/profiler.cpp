@@ -0,0 +1,121 @@
+import std;
+import xxas;
+import mint;
+
+#include "fixture.hpp"
+
+namespace mint_tests
+{
+    using namespace mint;
+
+    constexpr static auto keywords = arch::Keywords
+    {   // Registers.
+        std::pair{"gp0", Traits{traits::Bitness::b64, traits::Source::Register}},
+        std::pair{"gp1", Traits{traits::Bitness::b64, traits::Source::Register}},
+    };
+
+    constexpr static auto insns = arch::Insns
+    {
+        std::pair{"mov", [](auto& dest, const auto& src) -> void {
+            dest = src;
+        }},
+    };
+
+    constexpr inline Arch arch
+    {
+        insns, keywords
+    };
+
+    // Guest functions by their first ip.
+    const prof::Symbols symbols
+    {
+        {0x00, "main"},
+        {0x40, "foo"},
+        {0x80, "bar"},
+    };
+
+    // Emulates a guest call: pushes the return ip, then runs the callee prologue.
+    auto call(ThreadContext<arch>& ctx, const std::size_t target)
+        -> void
+    {
+        auto& data = ctx.get_data();
+        auto& mem  = *ctx.process->mem;
+
+        xxas::assert(ctx.stack_frame.push(mem, data.ip + 1uz).has_value(), "Return ip push should succeed");
+        xxas::assert(ctx.stack_frame.function_prologue(mem).has_value(), "Prologue should succeed");
+
+        data.ip = target;
+    };
+
+    void unwind_frames()
+    {
+        auto ctx = thread_context<arch>(stack::default_size);
+
+        // main -> foo -> bar.
+        ctx.get_data().ip = 0x10;
+        call(ctx, 0x44);
+        call(ctx, 0x88);
+
+        auto sample = Profiler::unwind(ctx);
+        xxas::assert_eq(sample.depth, 3uz);
+        xxas::assert_eq(sample.frames[0], 0x88uz);
+        xxas::assert_eq(sample.frames[1], 0x45uz);
+        xxas::assert_eq(sample.frames[2], 0x11uz);
+    };
+
+    void collapsed_stacks()
+    {
+        auto ctx = thread_context<arch>(stack::default_size);
+
+        Profiler profiler{};
+        auto& sampler = profiler.attach();
+
+        ctx.get_data().ip = 0x10;
+        call(ctx, 0x40);
+
+        // Request samples by hand, rather than through the timer.
+        for(auto n = 0; n < 2; ++n)
+        {
+            sampler.pending.store(true);
+            Profiler::poll(sampler, ctx);
+        };
+
+        // No request is pending; polling records nothing.
+        Profiler::poll(sampler, ctx);
+
+        xxas::assert_eq(profiler.collapse(symbols), std::string("main;foo 2\n"));
+    };
+
+    void timed_sampling()
+    {
+        auto ctx = thread_context<arch>(stack::default_size);
+
+        Profiler profiler{std::chrono::microseconds{100}};
+        auto& sampler = profiler.attach();
+
+        profiler.start();
+
+        // Poll as a guest thread would between instructions, until a sample is recorded.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+        while(sampler.ring.head.load() == 0uz && std::chrono::steady_clock::now() < deadline)
+        {
+            Profiler::poll(sampler, ctx);
+        };
+
+        profiler.stop();
+
+        xxas::assert(profiler.collapse(symbols).starts_with("main "), "Timer should request samples");
+    };
+
+    constexpr xxas::Tests profiler
+    {
+        unwind_frames,
+        collapsed_stacks,
+        timed_sampling,
+    };
+};
+
+int main()
+{
+    return mint_tests::profiler();
+};
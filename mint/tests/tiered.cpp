@@ -0,0 +1,253 @@
+import std;
+import xxas;
+import mint;
+
+#include "fixture.hpp"
+
+namespace mint_tests
+{
+    using namespace mint;
+
+    constexpr static auto keywords = arch::Keywords
+    {   // Registers.
+        std::pair{"gp0", Traits{traits::Bitness::b64, traits::Source::Register}},
+        std::pair{"gp1", Traits{traits::Bitness::b64, traits::Source::Register}},
+    };
+
+    constexpr static auto insns = arch::Insns
+    {
+        std::pair{"mov", [](auto& dest, const auto& src) -> void {
+            dest = src;
+        }},
+        std::pair{"add", [](auto& dest, const auto& a, const auto& b) -> void {
+            dest = a + b;
+        }},
+    };
+
+    constexpr inline Arch arch
+    {
+        insns, keywords
+    };
+
+    constexpr Traits reg64 = {traits::Bitness::b64, traits::Source::Register};
+    constexpr Traits imm64 = {traits::Bitness::b64, traits::Source::Immediate};
+
+    // Operand values; scalars reference them for as long as the programs run.
+    std::size_t   gp0  = 0uz;
+    std::size_t   gp1  = 1uz;
+    std::uint64_t zero = 0u;
+    std::uint64_t one  = 1u;
+
+    // `mov gp0, 0` followed by `count` repetitions of `add gp0, gp0, gp1`, with gp1 set to 1.
+    auto program(const std::size_t count)
+        -> Insns
+    {
+        Insns insns{};
+        insns.reserve(count + 2uz);
+
+        Instruction clear{.opcode = 0uz};
+        clear.operands.push_back(operand(Scalar::from(gp0), reg64));
+        clear.operands.push_back(operand(Scalar::from(zero), imm64));
+        insns.push_back(std::move(clear));
+
+        Instruction step{.opcode = 0uz};
+        step.operands.push_back(operand(Scalar::from(gp1), reg64));
+        step.operands.push_back(operand(Scalar::from(one), imm64));
+        insns.push_back(std::move(step));
+
+        for(auto n = 0uz; n < count; ++n)
+        {
+            Instruction add{.opcode = 1uz};
+            add.operands.push_back(operand(Scalar::from(gp0), reg64));
+            add.operands.push_back(operand(Scalar::from(gp0), reg64));
+            add.operands.push_back(operand(Scalar::from(gp1), reg64));
+            insns.push_back(std::move(add));
+        };
+
+        return insns;
+    };
+
+    // Returns the value of gp0.
+    auto accumulator(ThreadContext<arch>& ctx)
+        -> std::uint64_t
+    {
+        auto& reg = ctx.get_data().registers.at("gp0");
+        return Scalar{{reg.data(), reg.size()}}.as<std::uint64_t>();
+    };
+
+    // Runs the program `runs` times from its first instruction.
+    auto repeat(Tiered<arch>& tiered, ThreadContext<arch>& ctx, const std::size_t runs)
+        -> void
+    {
+        for(auto n = 0uz; n < runs; ++n)
+        {
+            ctx.get_data().ip = 0uz;
+            xxas::assert(tiered.run(ctx).has_value(), "Program should execute");
+        };
+    };
+
+    void hot_block_promotion()
+    {
+        auto ctx   = thread_context<arch>(stack::default_size);
+        auto insns = program(14uz);
+
+        Tiered<arch> tiered{insns, 4uz, 3uz};
+
+        // Below the threshold, every block stays interpreted.
+        repeat(tiered, ctx, 2uz);
+        xxas::assert_eq(accumulator(ctx), 14u);
+        xxas::assert(tiered.state(0uz) == tier::State::Interpreted, "Cold blocks should be interpreted");
+
+        // Crossing it queues each block for the compiler.
+        repeat(tiered, ctx, 1uz);
+        tiered.flush();
+
+        for(auto index = 0uz; index < tiered.block_count; ++index)
+        {
+            xxas::assert(tiered.state(index) == tier::State::Compiled, "Hot blocks should be compiled");
+        };
+
+        // Compiled blocks give the same results.
+        repeat(tiered, ctx, 1uz);
+        xxas::assert_eq(accumulator(ctx), 14u);
+    };
+
+    void resumes_mid_block()
+    {
+        auto ctx   = thread_context<arch>(stack::default_size);
+        auto insns = program(6uz);
+
+        Tiered<arch> tiered{insns, 4uz, 1uz};
+
+        repeat(tiered, ctx, 1uz);
+        tiered.flush();
+
+        // Starting past the first instruction keeps the previous accumulator.
+        ctx.get_data().ip = 3uz;
+        xxas::assert(tiered.run(ctx).has_value(), "Program should execute");
+        xxas::assert_eq(accumulator(ctx), 11u);
+        xxas::assert_eq(ctx.get_data().ip, insns.size());
+    };
+
+    // Compares time-to-first-instruction and steady-state throughput against eager lowering.
+    void startup_and_throughput()
+    {
+        constexpr auto count = 0x4000uz;
+        constexpr auto runs  = 0x40uz;
+
+        using Clock = std::chrono::steady_clock;
+        auto insns  = program(count);
+
+        // Eager: lower the whole program, then execute its first instruction.
+        auto ctx   = thread_context<arch>(stack::default_size);
+        auto start = Clock::now();
+
+        auto lowered = Dispatch<arch>::lower(insns);
+        xxas::assert(lowered.has_value(), "Program should lower");
+        xxas::assert(std::invoke((*lowered)[0], insns[0], ctx).has_value(), "First instruction should execute");
+
+        auto eager_first = Clock::now() - start;
+
+        // Tiered: execute the first instruction straight away.
+        start = Clock::now();
+
+        Tiered<arch> tiered{insns};
+        xxas::assert(Dispatch<arch>::execute(insns[0], ctx).has_value(), "First instruction should execute");
+
+        auto tiered_first = Clock::now() - start;
+
+        // Steady state: the tiered executor warms up, then runs compiled blocks.
+        repeat(tiered, ctx, tier::default_threshold);
+        tiered.flush();
+
+        start = Clock::now();
+        repeat(tiered, ctx, runs);
+        auto tiered_steady = Clock::now() - start;
+
+        start = Clock::now();
+        for(auto n = 0uz; n < runs; ++n)
+        {
+            for(const auto& [handler, insn]: std::views::zip(*lowered, insns))
+            {
+                static_cast<void>(std::invoke(handler, insn, ctx));
+            };
+        };
+        auto eager_steady = Clock::now() - start;
+
+        // Interpreted only: a threshold that's never reached.
+        Tiered<arch> interpreted{insns, tier::default_block_size, std::numeric_limits<std::size_t>::max()};
+
+        start = Clock::now();
+        repeat(interpreted, ctx, runs);
+        auto interpreted_steady = Clock::now() - start;
+
+        xxas::assert_eq(accumulator(ctx), count);
+
+        auto rate = [](const auto elapsed)
+        {
+            return static_cast<double>(count * runs) / std::chrono::duration<double>(elapsed).count() / 1e6;
+        };
+
+        std::println("time to first instruction: eager {}, tiered {}",
+            std::chrono::duration_cast<std::chrono::microseconds>(eager_first), std::chrono::duration_cast<std::chrono::microseconds>(tiered_first));
+
+        std::println("steady state (M insns/s): eager {:.1f}, tiered {:.1f}, interpreted {:.1f}",
+            rate(eager_steady), rate(tiered_steady), rate(interpreted_steady));
+    };
+
+    // Samples a running thread through the executor, and compares the cost of polling against none.
+    void sampled_execution()
+    {
+        constexpr auto count = 0x4000uz;
+        constexpr auto runs  = 0x40uz;
+
+        using Clock = std::chrono::steady_clock;
+
+        auto ctx   = thread_context<arch>(stack::default_size);
+        auto insns = program(count);
+
+        Tiered<arch> tiered{insns};
+        repeat(tiered, ctx, tier::default_threshold);
+        tiered.flush();
+
+        auto start = Clock::now();
+        repeat(tiered, ctx, runs);
+        auto unsampled = Clock::now() - start;
+
+        Profiler profiler{std::chrono::microseconds{100}};
+        auto& sampler = profiler.attach();
+
+        profiler.start();
+        start = Clock::now();
+
+        for(auto n = 0uz; n < runs; ++n)
+        {
+            ctx.get_data().ip = 0uz;
+            xxas::assert(tiered.run(ctx, &sampler).has_value(), "Program should execute");
+        };
+
+        auto sampled = Clock::now() - start;
+        profiler.stop();
+
+        auto samples = profiler.collapse();
+        xxas::assert(!samples.empty(), "Running threads should be sampled");
+        xxas::assert_eq(accumulator(ctx), count);
+
+        std::println("polling overhead: unsampled {}, sampled {} ({:+.1f}%)",
+            std::chrono::duration_cast<std::chrono::microseconds>(unsampled), std::chrono::duration_cast<std::chrono::microseconds>(sampled),
+            (std::chrono::duration<double>(sampled) / std::chrono::duration<double>(unsampled) - 1.0) * 100.0);
+    };
+
+    constexpr xxas::Tests tiered
+    {
+        hot_block_promotion,
+        resumes_mid_block,
+        startup_and_throughput,
+        sampled_execution,
+    };
+};
+
+int main()
+{
+    return mint_tests::tiered();
+};
@@ -0,0 +1,240 @@
+import std;
+import xxas;
+import mint;
+
+#include "fixture.hpp"
+
+namespace mint_tests
+{
+    using namespace mint;
+
+    // Builds a wide integer from its limbs, least significant first.
+    template<std::size_t Bits, class... Limbs> constexpr auto make(const Limbs... limbs)
+        -> Wide<Bits>
+    {
+        Wide<Bits> value{};
+        value.limbs = {static_cast<wide::Limb>(limbs)...};
+
+        return value;
+    };
+
+    constexpr auto ones = ~std::uint64_t{0};
+
+    // Carry and borrow chains across every limb.
+    static_assert(make<256>(ones, ones, ones, 0u) + u256{1u} == make<256>(0u, 0u, 0u, 1u));
+    static_assert(make<256>(0u, 0u, 0u, 1u) - u256{1u} == make<256>(ones, ones, ones, 0u));
+    static_assert(u256::max() + u256{1u} == u256{});
+    static_assert(u256{} - u256{1u} == u256::max());
+    static_assert(-u128{1u} == u128::max());
+    static_assert(u128{-1} == u128::max());
+
+    // Shifts across limb boundaries.
+    static_assert((u256{1u} << 130uz) == make<256>(0u, 0u, 4u, 0u));
+    static_assert((make<256>(0u, 0u, 4u, 0u) >> 67uz) == make<256>(1ull << 63, 0u, 0u, 0u));
+    static_assert((u128::max() << 128uz) == u128{});
+
+    // Ordering from the most significant limb.
+    static_assert(make<128>(ones, 0u) < make<128>(0u, 1u));
+    static_assert(u512{7u} > u512{6u});
+
+    // (2^512 - 1)^2 = 2^1024 - 2^513 + 1, through the Karatsuba split.
+    static_assert([]
+    {
+        auto product = u512::multiply(u512::max(), u512::max());
+        auto expect  = Wide<1024>{1u};
+
+        for(auto n = 8uz; n < 16uz; ++n)
+        {
+            expect.limbs[n] = ones;
+        };
+        expect.limbs[8] = ones - 1u;
+
+        return product == expect;
+    }());
+
+    // Karatsuba and truncated schoolbook products agree on the low half; dividing out a factor recovers the other.
+    static_assert([]
+    {
+        auto a = make<512>(0x0123456789abcdefu, ones, 0xfedcba9876543210u, 3u, ones, 0u, 0x8000000000000000u, 0x1111u);
+        auto b = make<512>(ones, 0x0f0f0f0f0f0f0f0fu, 0u, ones, 5u, ones, 0x7fffffffffffffffu, ones);
+
+        auto product = u512::multiply(a, b);
+        auto [quotient, remainder] = Wide<1024>::divmod(product, Wide<1024>{b});
+
+        return u512{product} == a * b && quotient == Wide<1024>{a} && remainder == Wide<1024>{};
+    }());
+
+    // Division: q * v + r == u and r < v, for single and multiple limb divisors.
+    static_assert([]
+    {
+        auto u = make<256>(0x243f6a8885a308d3u, 0x13198a2e03707344u, 0xa4093822299f31d0u, 0x082efa98ec4e6c89u);
+
+        for(const auto& v: {u256{10u}, make<256>(ones, 1u, 0u, 0u), make<256>(3u, 0u, 0x452821e638d01377u, 0u), u})
+        {
+            auto [q, r] = u256::divmod(u, v);
+            if(q * v + r != u || !(r < v))
+            {
+                return false;
+            };
+        };
+
+        return true;
+    }());
+
+    // Division by zero gives all ones, keeping the dividend as the remainder.
+    static_assert(u256{5u} / u256{} == u256::max());
+    static_assert(u256{5u} % u256{} == u256{5u});
+
+    // Saturation at the bounds.
+    static_assert(wide::add_sat(u128::max(), u128{1u}) == u128::max());
+    static_assert(wide::sub_sat(u128{1u}, u128{2u}) == u128{});
+    static_assert(wide::mul_sat(u128{1u} << 64uz, u128{1u} << 64uz) == u128::max());
+    static_assert(wide::mul_sat(u128{1u} << 63uz, u128{2u}) == u128{1u} << 64uz);
+
+    constexpr static auto keywords = arch::Keywords
+    {   // Registers.
+        std::pair{"wd0", Traits{traits::Bitness::b256, traits::Source::Register}},
+        std::pair{"wd1", Traits{traits::Bitness::b256, traits::Source::Register}},
+        std::pair{"xd0", Traits{traits::Bitness::b128, traits::Source::Register}},
+    };
+
+    constexpr static auto insns = arch::Insns
+    {
+        std::pair{"mov", [](auto& dest, const auto& src) -> void {
+            dest = src;
+        }},
+        std::pair{"mul", [](auto& dest, const auto& a, const auto& b) -> void {
+            dest = a * b;
+        }},
+    };
+
+    constexpr inline Arch arch
+    {
+        insns, keywords
+    };
+
+    // Wide words are specialized up to the widest register.
+    static_assert(dispatch::widths<arch> == traits::index(traits::Bitness::b256) + 1uz);
+
+    constexpr Traits reg256 = {traits::Bitness::b256, traits::Source::Register};
+    constexpr Traits imm256 = {traits::Bitness::b256, traits::Source::Immediate};
+    constexpr Traits reg128 = {traits::Bitness::b128, traits::Source::Register};
+    constexpr Traits imm128 = {traits::Bitness::b128, traits::Source::Immediate};
+
+    void scalar_binding()
+    {
+        auto value = make<256>(1u, 2u, 3u, 4u);
+
+        // Scalars reinterpret their bytes in place.
+        auto scalar = Scalar::from(value);
+        xxas::assert(scalar.as<u256>() == value, "Scalar should bind a wide integer");
+
+        scalar.as<u256>() += u256{1u};
+        xxas::assert(value == make<256>(2u, 2u, 3u, 4u), "Scalar should write through to the wide integer");
+
+        // Expressions evaluate their leaves as wide integers.
+        xxas::assert(Expression{Scalar::from(value)}.evaluate<u256>() == value, "Expression should evaluate a wide integer");
+    };
+
+    void formatting()
+    {
+        xxas::assert_eq(std::format("{}", u128::max()), std::string{"340282366920938463463374607431768211455"});
+        xxas::assert_eq(std::format("{}", u256{}), std::string{"0"});
+        xxas::assert_eq(std::format("{:x}", u128{1u} << 64uz), std::string{"10000000000000000"});
+    };
+
+    void wide_registers()
+    {
+        auto ctx = thread_context<arch>();
+
+        std::size_t wd0 = 0uz, wd1 = 1uz, xd0 = 2uz;
+        auto        a   = make<256>(ones, ones, 0u, 0u);
+        auto        b   = make<128>(0u, 1u);
+
+        // mov wd1, a
+        Instruction load{.opcode = 0uz};
+        load.operands.push_back(operand(Scalar::from(wd1), reg256));
+        load.operands.push_back(operand(Scalar::from(a), imm256));
+
+        // mul wd0, wd1, wd1
+        Instruction square{.opcode = 1uz};
+        square.operands.push_back(operand(Scalar::from(wd0), reg256));
+        square.operands.push_back(operand(Scalar::from(wd1), reg256));
+        square.operands.push_back(operand(Scalar::from(wd1), reg256));
+
+        // mov xd0, b
+        Instruction narrow{.opcode = 0uz};
+        narrow.operands.push_back(operand(Scalar::from(xd0), reg128));
+        narrow.operands.push_back(operand(Scalar::from(b), imm128));
+
+        for(const auto& insn: {std::cref(load), std::cref(square), std::cref(narrow)})
+        {
+            xxas::assert(Dispatch<arch>::execute(insn, ctx).has_value(), "Wide instruction should execute");
+        };
+
+        // (2^128 - 1)^2 = 2^256 - 2^129 + 1.
+        xxas::assert(read<u256>(ctx, "wd0") == make<256>(1u, 0u, ones - 1u, ones), "256-bit product should be exact");
+        xxas::assert(read<u128>(ctx, "xd0") == b, "128-bit register should hold the immediate");
+    };
+
+    // Times the multiply and reduction steps of a 256-bit modular exponentiation, as in elliptic curve arithmetic.
+    void crypto_kernel()
+    {
+        constexpr auto rounds = 0x4000uz;
+
+        using Clock = std::chrono::steady_clock;
+
+        // 2^255 - 19.
+        auto modulus = (u256{1u} << 255uz) - u256{19u};
+        auto reducer = Wide<512>{modulus};
+        auto base    = make<256>(0x243f6a8885a308d3u, 0x13198a2e03707344u, 0xa4093822299f31d0u, 0x082efa98ec4e6c89u);
+
+        // Square and multiply, reducing the full product after each step.
+        auto start = Clock::now();
+        auto acc   = u256{1u};
+
+        for(auto n = 0uz; n < rounds; ++n)
+        {
+            acc = u256{u256::multiply(acc, acc) % reducer};
+            acc = u256{u256::multiply(acc, base) % reducer};
+        };
+
+        auto modmul = Clock::now() - start;
+
+        // Full 512-bit products, split by Karatsuba.
+        start        = Clock::now();
+        auto a       = u512{base} << 200uz | u512{acc};
+        auto product = Wide<1024>{};
+
+        for(auto n = 0uz; n < rounds; ++n)
+        {
+            product = u512::multiply(a, a);
+            a       = a + u512{product >> 512uz};
+        };
+
+        auto karatsuba = Clock::now() - start;
+
+        xxas::assert(acc < modulus, "Reduced value should stay below the modulus");
+
+        auto rate = [](const auto elapsed, const std::size_t ops)
+        {
+            return static_cast<double>(ops) / std::chrono::duration<double>(elapsed).count() / 1e6;
+        };
+
+        std::println("256-bit modular multiply (M ops/s): {:.2f}, result {:x}", rate(modmul, rounds * 2uz), acc);
+        std::println("512-bit full multiply (M ops/s): {:.2f}, result {:x}", rate(karatsuba, rounds), u512{product});
+    };
+
+    constexpr xxas::Tests wide
+    {
+        scalar_binding,
+        formatting,
+        wide_registers,
+        crypto_kernel,
+    };
+};
+
+int main()
+{
+    return mint_tests::wide();
+};
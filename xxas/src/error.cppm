@@ -4,22 +4,86 @@ import std;
 import :meta;
 
 namespace xxas
-{   // Simple error, and error propagating container.
+{
+    namespace err
+    {   // Text argument of static storage duration, such as a literal or an interned string; stored by pointer.
+        export struct Text
+        {
+            const char* text;
+        };
+
+        // Copies `text` into storage kept for the life of the process, for an error to refer to.
+        // Allocates and never releases; meant for context on cold paths, such as the path of a file that failed to open.
+        export auto intern(const std::string_view text)
+            -> Text
+        {
+            static std::mutex                      mutex{};
+            static std::unordered_set<std::string> texts{};
+
+            std::scoped_lock lock(mutex);
+            return Text{texts.emplace(text).first->c_str()};
+        };
+
+        // Types an error argument may be; `bool` and characters would be formatted as the integers they're stored as.
+        export template<class T> concept argument = (meta::arithmetic<T> && !std::same_as<T, bool>
+            && !std::same_as<T, char> && !std::same_as<T, wchar_t> && !std::same_as<T, char8_t>
+            && !std::same_as<T, char16_t> && !std::same_as<T, char32_t>) || meta::enumerable<T> || std::same_as<T, Text>;
+
+        // Type an argument is stored, and formatted, as.
+        template<class T> struct Stored: std::type_identity<std::uint64_t> {};
+        template<std::signed_integral T> struct Stored<T>: std::type_identity<std::int64_t> {};
+        template<std::floating_point T> struct Stored<T>: std::type_identity<double> {};
+        template<meta::enumerable T> struct Stored<T>: Stored<std::underlying_type_t<T>> {};
+        template<> struct Stored<Text>: std::type_identity<const char*> {};
+
+        // Compile-time checked format string of static storage duration; formatted only when read.
+        export template<class... Args> struct Format
+        {
+            const char* text;
+
+            consteval Format(const char* text)
+                : text{text}
+            {   // Validate the format string against the types the arguments are formatted as.
+                static_cast<void>(std::format_string<typename Stored<Args>::type...>(text));
+            };
+        };
+
+        // Category of a stored error argument.
+        export enum class Kind: std::uint8_t
+        {
+            None, Unsigned, Signed, Floating, Text,
+        };
+    };
+
+    // Simple error, and error propagating container.
+    // Trivially copyable: a code, a static format string, and at most one arithmetic or static text argument.
     export template<class Err = std::uint8_t, class... Errs> struct Error
     {   // Drain previous possible error types into a single variant.
         using Enum = meta::DedupExtend_t<std::variant<Err>, Errs...>;
 
-        Enum        type{};
-        std::string message{};
+        Enum          type{};
+        err::Kind     kind{err::Kind::None};
+        const char*   format{""};
+        std::uint64_t argument{};
+
+        constexpr Error() noexcept = default;
 
-        constexpr Error(meta::same_as<Err, Errs...> auto&& type, std::string&& message) noexcept
-            : type{std::move(type)}, message{std::move(message)} {};
+        template<err::argument... Args> requires(sizeof...(Args) <= 1uz)
+        constexpr Error(meta::same_as<Err, Errs...> auto&& type, std::type_identity_t<err::Format<Args...>> format, const Args&... args) noexcept
+            : type{std::move(type)}, format{format.text}
+        {
+            (this->store(args), ...);
+        };
 
-        constexpr Error(std::string&& message)
-            : type{}, message{std::move(message)} {};
+        template<err::argument... Args> requires(sizeof...(Args) <= 1uz)
+        constexpr Error(std::type_identity_t<err::Format<Args...>> format, const Args&... args) noexcept
+            : type{}, format{format.text}
+        {
+            (this->store(args), ...);
+        };
 
-        template<class... From> explicit constexpr Error(Error<From...>&& from) noexcept
-            : message{std::move(from.message)}
+        template<class... From> explicit constexpr Error(const Error<From...>& from) noexcept
+            : kind{from.kind}, format{from.format}, argument{from.argument}
         {
             constexpr auto default_initialize = [](auto&&...) noexcept
             {
@@ -36,12 +100,76 @@ namespace xxas
                 default_initialize, move_initialize,
             });
         };
+
+        // Formats the message; the only point an error allocates.
+        auto message() const
+            -> std::string
+        {
+            switch(this->kind)
+            {
+                case err::Kind::Unsigned:
+                {
+                    return std::vformat(this->format, std::make_format_args(this->argument));
+                };
+                case err::Kind::Signed:
+                {
+                    auto value = std::bit_cast<std::int64_t>(this->argument);
+                    return std::vformat(this->format, std::make_format_args(value));
+                };
+                case err::Kind::Floating:
+                {
+                    auto value = std::bit_cast<double>(this->argument);
+                    return std::vformat(this->format, std::make_format_args(value));
+                };
+                case err::Kind::Text:
+                {
+                    auto value = reinterpret_cast<const char*>(static_cast<std::uintptr_t>(this->argument));
+                    return std::vformat(this->format, std::make_format_args(value));
+                };
+                default:
+                {
+                    return std::vformat(this->format, std::make_format_args());
+                };
+            };
+        };
+
+      private:
+        // Stores an argument as its 64-bit representation.
+        template<err::argument T> constexpr auto store(const T& value) noexcept
+            -> void
+        {
+            if constexpr(meta::enumerable<T>)
+            {
+                this->store(std::to_underlying(value));
+            }
+            else if constexpr(std::same_as<T, err::Text>)
+            {
+                this->kind     = err::Kind::Text;
+                this->argument = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value.text));
+            }
+            else if constexpr(std::floating_point<T>)
+            {
+                this->kind     = err::Kind::Floating;
+                this->argument = std::bit_cast<std::uint64_t>(static_cast<double>(value));
+            }
+            else if constexpr(std::signed_integral<T>)
+            {
+                this->kind     = err::Kind::Signed;
+                this->argument = std::bit_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+            }
+            else
+            {
+                this->kind     = err::Kind::Unsigned;
+                this->argument = static_cast<std::uint64_t>(value);
+            };
+        };
     };
 
-    export template<class T> auto error(T&& type, std::string&& message)
+    export template<class T, err::argument... Args> requires(sizeof...(Args) <= 1uz)
+    constexpr auto error(T type, std::type_identity_t<err::Format<Args...>> format, const Args&... args) noexcept
         -> Error<T>
     {
-        return Error<T>{std::move(type), std::move(message)};
+        return Error<T>{std::move(type), format, args...};
     };
 
     export template<class T, class... Errs> struct Result: std::expected<T, Error<Errs...>>
@@ -138,6 +266,6 @@ struct std::formatter<xxas::Error<En, From...>>
             };
         });
 
-        return std::format_to(ctx.out(), "Error {{ type: {}, message: {} }}", type_str, error.message);
+        return std::format_to(ctx.out(), "Error {{ type: {}, message: {} }}", type_str, error.message());
     };
 };
@@ -58,9 +58,79 @@ namespace xxas_tests
         xxas::assert_eq(std::holds_alternative<AErr>(result_b.error().type), true);
     };
  
+    // Errors copy as plain bytes, and results carrying them never allocate.
+    static_assert(std::is_trivially_copyable_v<AError>);
+    static_assert(std::is_trivially_copyable_v<BResult>);
+    static_assert(sizeof(AError) <= 3uz * sizeof(std::uint64_t));
+
+    constexpr auto lazy_message()
+    {   // The message is only formatted once read.
+        AError unsigned_err{AErr::Problem, "vaddr of {:#x} is out of range", std::uintptr_t{0x2000}};
+        AError signed_err{AErr::Problem, "offset {}", -4};
+        AError plain_err{AErr::Problem, "no {{arguments}}"};
+
+        xxas::assert_eq(unsigned_err.message(), std::string("vaddr of 0x2000 is out of range"));
+        xxas::assert_eq(signed_err.message(), std::string("offset -4"));
+        xxas::assert_eq(plain_err.message(), std::string("no {arguments}"));
+
+        // Propagation keeps the message.
+        BError berr{std::move(unsigned_err)};
+        xxas::assert_eq(berr.message(), std::string("vaddr of 0x2000 is out of range"));
+    };
+
+    // Arguments that would format differently from how they're stored are rejected.
+    static_assert(!xxas::err::argument<bool> && !xxas::err::argument<char>);
+    static_assert(xxas::err::argument<AErr> && xxas::err::argument<xxas::err::Text>);
+
+    auto text_arguments()
+    {   // Enumerations are formatted as their underlying value.
+        AError enum_err{AErr::Problem, "code {:#x}", BErr::Problem};
+        xxas::assert_eq(enum_err.message(), std::string("code 0x7"));
+
+        // Dynamic text is interned, keeping the error trivially copyable.
+        auto path = std::string("missing.bin");
+        AError text_err{AErr::Problem, "cannot open {}", xxas::err::intern(path)};
+
+        path.clear();
+        xxas::assert_eq(text_err.message(), std::string("cannot open missing.bin"));
+        xxas::assert_eq(xxas::err::intern("missing.bin").text, xxas::err::intern("missing.bin").text);
+    };
+
+    auto fault_path()
+    {   // Probes that mostly fail, as a guest scanning unmapped memory would.
+        constexpr auto probes = 1'000'000;
+
+        auto probe = [](const std::uintptr_t vaddr)
+            -> AResult
+        {
+            if(vaddr % 64u != 0u)
+            {
+                return xxas::error(AErr::Problem, "vaddr of {:#x} is out of range", vaddr);
+            };
+
+            return static_cast<int>(vaddr);
+        };
+
+        auto start  = std::chrono::steady_clock::now();
+        auto faults = 0uz;
+
+        for(std::uintptr_t vaddr = 0u; vaddr < probes; ++vaddr)
+        {
+            if(auto result = probe(vaddr); !result)
+            {
+                faults = faults + 1uz;
+            };
+        };
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        std::println("{} faults in {}", faults, duration);
+
+        xxas::assert_eq(faults, static_cast<std::size_t>(probes - probes / 64));
+    };
+
     constexpr inline auto error = xxas::Tests
     {
-        error_init, result_init
+        error_init, result_init, lazy_message, text_arguments, fault_path
     };
 };
 